@@ -0,0 +1,72 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace rsm {
+
+// Conversions of 32-bit fixed-point samples in [0..2^32) (i.e. uint32_t sampler output) to [0..1) floating-point values.
+// Only the most significant bits are kept so that every result is exactly representable and strictly less than one.
+
+inline float fixed_to_float(uint32_t value)
+{
+    return (value >> 8) * (1.0f / 16777216.0f);
+}
+
+inline double fixed_to_double(uint32_t value)
+{
+    return value * (1.0 / 4294967296.0);
+}
+
+// Returns IEEE 754 binary16 bit pattern.
+inline uint16_t fixed_to_half(uint32_t value)
+{
+    float f = (value >> 21) * (1.0f / 2048.0f);
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    // Rebias exponent from 127 to 15; all values are exact normals (or zero) in half precision.
+    return (bits != 0) ? static_cast<uint16_t>((bits >> 13) - 0x1c000u) : uint16_t(0);
+}
+
+// Returns 16-bit fixed-point value in [0..2^16).
+inline uint16_t fixed_to_u16(uint32_t value)
+{
+    return static_cast<uint16_t>(value >> 16);
+}
+
+inline void fixed_to_float(const uint32_t* input, float* output, size_t count)
+{
+    for(size_t i=0; i<count; ++i) {
+        output[i] = fixed_to_float(input[i]);
+    }
+}
+
+inline void fixed_to_double(const uint32_t* input, double* output, size_t count)
+{
+    for(size_t i=0; i<count; ++i) {
+        output[i] = fixed_to_double(input[i]);
+    }
+}
+
+inline void fixed_to_half(const uint32_t* input, uint16_t* output, size_t count)
+{
+    for(size_t i=0; i<count; ++i) {
+        output[i] = fixed_to_half(input[i]);
+    }
+}
+
+inline void fixed_to_u16(const uint32_t* input, uint16_t* output, size_t count)
+{
+    for(size_t i=0; i<count; ++i) {
+        output[i] = fixed_to_u16(input[i]);
+    }
+}
+
+} // rsm
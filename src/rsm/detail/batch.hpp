@@ -0,0 +1,44 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "../layout.hpp"
+
+namespace rsm {
+namespace detail {
+
+// Applies a warp f(const U* u, U* p) taking In uniform variates and producing Out components to a batch of samples.
+// The warp is inlined into a single loop with no dependencies between iterations so the compiler can vectorize it.
+
+template<unsigned int In, unsigned int Out, typename U, typename F>
+void warp_batch(const U* u, U* p, size_t count, F&& f)
+{
+    for(size_t i=0; i<count; ++i) {
+        f(u + In * i, p + Out * i);
+    }
+}
+
+template<unsigned int In, unsigned int Out, typename V, typename U, typename F>
+void warp_batch(const soa_buffer<V, In>& u, const soa_buffer<U, Out>& p, size_t count, F&& f)
+{
+    for(size_t i=0; i<count; ++i) {
+        U ui[In];
+        U pi[Out];
+        for(unsigned int dim=0; dim<In; ++dim) {
+            ui[dim] = u.data[dim][i];
+        }
+        f(static_cast<const U*>(ui), static_cast<U*>(pi));
+        for(unsigned int dim=0; dim<Out; ++dim) {
+            p.data[dim][i] = pi[dim];
+        }
+    }
+}
+
+} // detail
+} // rsm
@@ -12,6 +12,10 @@
 #include <algorithm>
 #include <type_traits>
 
+#ifndef RSM_MAX_LDS_DIMENSIONS
+#define RSM_MAX_LDS_DIMENSIONS 128
+#endif
+
 namespace rsm {
 namespace detail {
 
@@ -26,6 +30,7 @@ template<> constexpr double inv_pi() { return 1.0 / pi<double>(); }
 template<typename T> constexpr T one_minus_eps() = delete;
 template<> constexpr float  one_minus_eps() { return 0.99999994f; }
 template<> constexpr double one_minus_eps() { return 0.99999999999999989; }
+template<> constexpr uint32_t one_minus_eps() { return 0xffffffffu; }
 
 template<typename T>
 struct component
@@ -64,5 +69,15 @@ inline double u64_as_double(uint64_t value)
     return r.d - 1.0;
 }
 
+inline uint32_t reverse_bits(uint32_t value)
+{
+    value = (value << 16) | (value >> 16);
+    value = ((value & 0x00ff00fful) << 8) | ((value & 0xff00ff00ul) >> 8);
+    value = ((value & 0x0f0f0f0ful) << 4) | ((value & 0xf0f0f0f0ul) >> 4);
+    value = ((value & 0x33333333ul) << 2) | ((value & 0xccccccccul) >> 2);
+    value = ((value & 0x55555555ul) << 1) | ((value & 0xaaaaaaaaul) >> 1);
+    return value;
+}
+
 } // detail
 } // rsm
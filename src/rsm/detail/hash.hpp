@@ -0,0 +1,50 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "common.hpp"
+
+namespace rsm {
+namespace detail {
+
+// SplitMix64 output function: bijective 64-bit mixer with good avalanche properties.
+inline uint64_t mix64(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// Stateless hashes of integer tuples used for counter-based random streams.
+inline uint64_t hash(uint64_t a, uint64_t b)
+{
+    return mix64(a ^ mix64(b + 0x9e3779b97f4a7c15ull));
+}
+
+inline uint64_t hash(uint64_t a, uint64_t b, uint64_t c)
+{
+    return hash(hash(a, b), c);
+}
+
+template<typename T> T hash_variate(uint64_t h) = delete;
+
+template<>
+inline float hash_variate(uint64_t h)
+{
+    return u32_as_float(static_cast<uint32_t>(h >> 32));
+}
+
+template<>
+inline double hash_variate(uint64_t h)
+{
+    return u64_as_double(h);
+}
+
+} // detail
+} // rsm
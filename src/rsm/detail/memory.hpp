@@ -10,6 +10,8 @@
 #include <cstddef>
 #include <cstdlib>
 
+#include "../stats.hpp"
+
 #ifndef RSM_DEFAULT_ALIGNMENT
 #define RSM_DEFAULT_ALIGNMENT 16
 #endif
@@ -45,7 +47,14 @@ template<typename T>
 T* alloc(const allocator_t& allocator, size_t n)
 {
     assert(allocator.fn_alloc);
-    return reinterpret_cast<T*>(allocator.fn_alloc(sizeof(T) * n, RSM_DEFAULT_ALIGNMENT, allocator.user_data));
+    T* ptr = reinterpret_cast<T*>(allocator.fn_alloc(sizeof(T) * n, RSM_DEFAULT_ALIGNMENT, allocator.user_data));
+#ifdef RSM_ENABLE_STATS
+    if(ptr) {
+        RSM_STATS_ADD(num_allocations, 1);
+        RSM_STATS_ADD(bytes_allocated, sizeof(T) * n);
+    }
+#endif
+    return ptr;
 }
 
 template<typename T>
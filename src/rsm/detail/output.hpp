@@ -0,0 +1,106 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#include "../layout.hpp"
+
+namespace rsm {
+namespace detail {
+
+// Output adapters used by sampler kernels to store generated values in caller-provided buffers.
+
+// Scalar buffer with N interleaved components per sample.
+template<unsigned int N>
+struct interleaved_output
+{
+    template<typename T, typename Scalar>
+    static void store(T* buffer, size_t index, unsigned int dim, Scalar value)
+    {
+        buffer[index * N + dim] = value;
+    }
+    template<typename T>
+    static T* advance(T* buffer, size_t index)
+    {
+        return buffer + index * N;
+    }
+    template<typename T>
+    static void swap(T* buffer, size_t a, size_t b, unsigned int dim)
+    {
+        std::swap(buffer[a * N + dim], buffer[b * N + dim]);
+    }
+};
+
+// Buffer of vector-like types supporting operator[].
+struct vector_output
+{
+    template<typename T, typename Scalar>
+    static void store(T* buffer, size_t index, unsigned int dim, Scalar value)
+    {
+        buffer[index][dim] = value;
+    }
+    template<typename T>
+    static T* advance(T* buffer, size_t index)
+    {
+        return buffer + index;
+    }
+    template<typename T>
+    static void swap(T* buffer, size_t a, size_t b, unsigned int dim)
+    {
+        std::swap(buffer[a][dim], buffer[b][dim]);
+    }
+};
+
+// One array per dimension (see soa_buffer).
+struct soa_output
+{
+    template<typename T, unsigned int N, typename Scalar>
+    static void store(const soa_buffer<T, N>& buffer, size_t index, unsigned int dim, Scalar value)
+    {
+        buffer.data[dim][index] = value;
+    }
+    template<typename T, unsigned int N>
+    static soa_buffer<T, N> advance(const soa_buffer<T, N>& buffer, size_t index)
+    {
+        soa_buffer<T, N> result;
+        for(unsigned int dim=0; dim<N; ++dim) {
+            result.data[dim] = buffer.data[dim] + index;
+        }
+        return result;
+    }
+    template<typename T, unsigned int N>
+    static void swap(const soa_buffer<T, N>& buffer, size_t a, size_t b, unsigned int dim)
+    {
+        std::swap(buffer.data[dim][a], buffer.data[dim][b]);
+    }
+};
+
+// Arbitrary sample & dimension strides (see strided_buffer).
+struct strided_output
+{
+    template<typename T, typename Scalar>
+    static void store(const strided_buffer<T>& buffer, size_t index, unsigned int dim, Scalar value)
+    {
+        buffer.data[index * buffer.sample_stride + dim * buffer.dim_stride] = value;
+    }
+    template<typename T>
+    static strided_buffer<T> advance(const strided_buffer<T>& buffer, size_t index)
+    {
+        return strided_buffer<T>{buffer.data + index * buffer.sample_stride, buffer.sample_stride, buffer.dim_stride};
+    }
+    template<typename T>
+    static void swap(const strided_buffer<T>& buffer, size_t a, size_t b, unsigned int dim)
+    {
+        std::swap(buffer.data[a * buffer.sample_stride + dim * buffer.dim_stride],
+                  buffer.data[b * buffer.sample_stride + dim * buffer.dim_stride]);
+    }
+};
+
+} // detail
+} // rsm
@@ -9,11 +9,40 @@
 #include <cstdint>
 #include <cmath>
 
+#include "common.hpp"
 #include "memory.hpp"
 
 namespace rsm {
 namespace detail {
 
+// First N primes computed at compile time; used to specialize radical inverse kernels on their base.
+template<unsigned int N>
+struct static_primes_t
+{
+    constexpr static_primes_t()
+        : p{}
+    {
+        p[0] = 2;
+        unsigned int i = 1;
+        for(uint32_t np = 3; i<N; np += 2) {
+            bool is_prime = true;
+            for(uint32_t divisor = 3; divisor * divisor <= np; divisor += 2) {
+                if((np % divisor) == 0) {
+                    is_prime = false;
+                    break;
+                }
+            }
+            if(is_prime) {
+                p[i++] = np;
+            }
+        }
+    }
+
+    uint32_t p[N];
+};
+
+constexpr static_primes_t<RSM_MAX_LDS_DIMENSIONS> g_static_primes{};
+
 struct primes_t
 {
     uint16_t N = 0;
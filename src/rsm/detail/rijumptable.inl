@@ -1,127 +0,0 @@
-// Generated by rijumptable.py for N=128
-case 2: return radical_inverse_scrambled<T>(5, perm, value);
-case 3: return radical_inverse_scrambled<T>(7, perm, value);
-case 4: return radical_inverse_scrambled<T>(11, perm, value);
-case 5: return radical_inverse_scrambled<T>(13, perm, value);
-case 6: return radical_inverse_scrambled<T>(17, perm, value);
-case 7: return radical_inverse_scrambled<T>(19, perm, value);
-case 8: return radical_inverse_scrambled<T>(23, perm, value);
-case 9: return radical_inverse_scrambled<T>(29, perm, value);
-case 10: return radical_inverse_scrambled<T>(31, perm, value);
-case 11: return radical_inverse_scrambled<T>(37, perm, value);
-case 12: return radical_inverse_scrambled<T>(41, perm, value);
-case 13: return radical_inverse_scrambled<T>(43, perm, value);
-case 14: return radical_inverse_scrambled<T>(47, perm, value);
-case 15: return radical_inverse_scrambled<T>(53, perm, value);
-case 16: return radical_inverse_scrambled<T>(59, perm, value);
-case 17: return radical_inverse_scrambled<T>(61, perm, value);
-case 18: return radical_inverse_scrambled<T>(67, perm, value);
-case 19: return radical_inverse_scrambled<T>(71, perm, value);
-case 20: return radical_inverse_scrambled<T>(73, perm, value);
-case 21: return radical_inverse_scrambled<T>(79, perm, value);
-case 22: return radical_inverse_scrambled<T>(83, perm, value);
-case 23: return radical_inverse_scrambled<T>(89, perm, value);
-case 24: return radical_inverse_scrambled<T>(97, perm, value);
-case 25: return radical_inverse_scrambled<T>(101, perm, value);
-case 26: return radical_inverse_scrambled<T>(103, perm, value);
-case 27: return radical_inverse_scrambled<T>(107, perm, value);
-case 28: return radical_inverse_scrambled<T>(109, perm, value);
-case 29: return radical_inverse_scrambled<T>(113, perm, value);
-case 30: return radical_inverse_scrambled<T>(127, perm, value);
-case 31: return radical_inverse_scrambled<T>(131, perm, value);
-case 32: return radical_inverse_scrambled<T>(137, perm, value);
-case 33: return radical_inverse_scrambled<T>(139, perm, value);
-case 34: return radical_inverse_scrambled<T>(149, perm, value);
-case 35: return radical_inverse_scrambled<T>(151, perm, value);
-case 36: return radical_inverse_scrambled<T>(157, perm, value);
-case 37: return radical_inverse_scrambled<T>(163, perm, value);
-case 38: return radical_inverse_scrambled<T>(167, perm, value);
-case 39: return radical_inverse_scrambled<T>(173, perm, value);
-case 40: return radical_inverse_scrambled<T>(179, perm, value);
-case 41: return radical_inverse_scrambled<T>(181, perm, value);
-case 42: return radical_inverse_scrambled<T>(191, perm, value);
-case 43: return radical_inverse_scrambled<T>(193, perm, value);
-case 44: return radical_inverse_scrambled<T>(197, perm, value);
-case 45: return radical_inverse_scrambled<T>(199, perm, value);
-case 46: return radical_inverse_scrambled<T>(211, perm, value);
-case 47: return radical_inverse_scrambled<T>(223, perm, value);
-case 48: return radical_inverse_scrambled<T>(227, perm, value);
-case 49: return radical_inverse_scrambled<T>(229, perm, value);
-case 50: return radical_inverse_scrambled<T>(233, perm, value);
-case 51: return radical_inverse_scrambled<T>(239, perm, value);
-case 52: return radical_inverse_scrambled<T>(241, perm, value);
-case 53: return radical_inverse_scrambled<T>(251, perm, value);
-case 54: return radical_inverse_scrambled<T>(257, perm, value);
-case 55: return radical_inverse_scrambled<T>(263, perm, value);
-case 56: return radical_inverse_scrambled<T>(269, perm, value);
-case 57: return radical_inverse_scrambled<T>(271, perm, value);
-case 58: return radical_inverse_scrambled<T>(277, perm, value);
-case 59: return radical_inverse_scrambled<T>(281, perm, value);
-case 60: return radical_inverse_scrambled<T>(283, perm, value);
-case 61: return radical_inverse_scrambled<T>(293, perm, value);
-case 62: return radical_inverse_scrambled<T>(307, perm, value);
-case 63: return radical_inverse_scrambled<T>(311, perm, value);
-case 64: return radical_inverse_scrambled<T>(313, perm, value);
-case 65: return radical_inverse_scrambled<T>(317, perm, value);
-case 66: return radical_inverse_scrambled<T>(331, perm, value);
-case 67: return radical_inverse_scrambled<T>(337, perm, value);
-case 68: return radical_inverse_scrambled<T>(347, perm, value);
-case 69: return radical_inverse_scrambled<T>(349, perm, value);
-case 70: return radical_inverse_scrambled<T>(353, perm, value);
-case 71: return radical_inverse_scrambled<T>(359, perm, value);
-case 72: return radical_inverse_scrambled<T>(367, perm, value);
-case 73: return radical_inverse_scrambled<T>(373, perm, value);
-case 74: return radical_inverse_scrambled<T>(379, perm, value);
-case 75: return radical_inverse_scrambled<T>(383, perm, value);
-case 76: return radical_inverse_scrambled<T>(389, perm, value);
-case 77: return radical_inverse_scrambled<T>(397, perm, value);
-case 78: return radical_inverse_scrambled<T>(401, perm, value);
-case 79: return radical_inverse_scrambled<T>(409, perm, value);
-case 80: return radical_inverse_scrambled<T>(419, perm, value);
-case 81: return radical_inverse_scrambled<T>(421, perm, value);
-case 82: return radical_inverse_scrambled<T>(431, perm, value);
-case 83: return radical_inverse_scrambled<T>(433, perm, value);
-case 84: return radical_inverse_scrambled<T>(439, perm, value);
-case 85: return radical_inverse_scrambled<T>(443, perm, value);
-case 86: return radical_inverse_scrambled<T>(449, perm, value);
-case 87: return radical_inverse_scrambled<T>(457, perm, value);
-case 88: return radical_inverse_scrambled<T>(461, perm, value);
-case 89: return radical_inverse_scrambled<T>(463, perm, value);
-case 90: return radical_inverse_scrambled<T>(467, perm, value);
-case 91: return radical_inverse_scrambled<T>(479, perm, value);
-case 92: return radical_inverse_scrambled<T>(487, perm, value);
-case 93: return radical_inverse_scrambled<T>(491, perm, value);
-case 94: return radical_inverse_scrambled<T>(499, perm, value);
-case 95: return radical_inverse_scrambled<T>(503, perm, value);
-case 96: return radical_inverse_scrambled<T>(509, perm, value);
-case 97: return radical_inverse_scrambled<T>(521, perm, value);
-case 98: return radical_inverse_scrambled<T>(523, perm, value);
-case 99: return radical_inverse_scrambled<T>(541, perm, value);
-case 100: return radical_inverse_scrambled<T>(547, perm, value);
-case 101: return radical_inverse_scrambled<T>(557, perm, value);
-case 102: return radical_inverse_scrambled<T>(563, perm, value);
-case 103: return radical_inverse_scrambled<T>(569, perm, value);
-case 104: return radical_inverse_scrambled<T>(571, perm, value);
-case 105: return radical_inverse_scrambled<T>(577, perm, value);
-case 106: return radical_inverse_scrambled<T>(587, perm, value);
-case 107: return radical_inverse_scrambled<T>(593, perm, value);
-case 108: return radical_inverse_scrambled<T>(599, perm, value);
-case 109: return radical_inverse_scrambled<T>(601, perm, value);
-case 110: return radical_inverse_scrambled<T>(607, perm, value);
-case 111: return radical_inverse_scrambled<T>(613, perm, value);
-case 112: return radical_inverse_scrambled<T>(617, perm, value);
-case 113: return radical_inverse_scrambled<T>(619, perm, value);
-case 114: return radical_inverse_scrambled<T>(631, perm, value);
-case 115: return radical_inverse_scrambled<T>(641, perm, value);
-case 116: return radical_inverse_scrambled<T>(643, perm, value);
-case 117: return radical_inverse_scrambled<T>(647, perm, value);
-case 118: return radical_inverse_scrambled<T>(653, perm, value);
-case 119: return radical_inverse_scrambled<T>(659, perm, value);
-case 120: return radical_inverse_scrambled<T>(661, perm, value);
-case 121: return radical_inverse_scrambled<T>(673, perm, value);
-case 122: return radical_inverse_scrambled<T>(677, perm, value);
-case 123: return radical_inverse_scrambled<T>(683, perm, value);
-case 124: return radical_inverse_scrambled<T>(691, perm, value);
-case 125: return radical_inverse_scrambled<T>(701, perm, value);
-case 126: return radical_inverse_scrambled<T>(709, perm, value);
-case 127: return radical_inverse_scrambled<T>(719, perm, value);
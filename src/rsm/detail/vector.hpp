@@ -0,0 +1,49 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cmath>
+
+namespace rsm {
+namespace detail {
+
+// Minimal 3D vector helpers operating on plain arrays.
+
+template<typename U>
+U dot3(const U* a, const U* b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+template<typename U>
+void cross3(const U* a, const U* b, U* r)
+{
+    const U x = a[1] * b[2] - a[2] * b[1];
+    const U y = a[2] * b[0] - a[0] * b[2];
+    const U z = a[0] * b[1] - a[1] * b[0];
+    r[0] = x;
+    r[1] = y;
+    r[2] = z;
+}
+
+template<typename U>
+U length3(const U* a)
+{
+    return std::sqrt(dot3(a, a));
+}
+
+template<typename U>
+void normalize3(U* a)
+{
+    const U inv_length = U(1.0) / length3(a);
+    a[0] *= inv_length;
+    a[1] *= inv_length;
+    a[2] *= inv_length;
+}
+
+} // detail
+} // rsm
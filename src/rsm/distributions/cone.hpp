@@ -0,0 +1,170 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+
+#include "../detail/common.hpp"
+#include "../detail/batch.hpp"
+#include "frame.hpp"
+
+namespace rsm {
+
+// Uniformly distributed unit direction within cone around +z axis with given cosine of its half-angle.
+template<typename U>
+void cone(U cos_theta_max, U u1, U u2, U& px, U& py, U& pz)
+{
+    U cos_theta = U(1.0) - u1 * (U(1.0) - cos_theta_max);
+    U sin_theta = std::sqrt(std::max(U(0.0), U(1.0) - cos_theta * cos_theta));
+    U phi = U(2.0) * detail::pi<U>() * u2;
+    px = std::cos(phi) * sin_theta;
+    py = std::sin(phi) * sin_theta;
+    pz = cos_theta;
+}
+
+// Cone around given unit axis.
+template<typename U>
+void cone(const U* axis, U cos_theta_max, U u1, U u2, U& px, U& py, U& pz)
+{
+    U local[3], t[3], b[3], r[3];
+    cone(cos_theta_max, u1, u2, local[0], local[1], local[2]);
+    orthonormal_basis(axis, t, b);
+    from_frame(t, b, axis, local, r);
+    px = r[0];
+    py = r[1];
+    pz = r[2];
+}
+
+template<typename U>
+constexpr U cone_pdf(U cos_theta_max)
+{
+    return U(0.5) * detail::inv_pi<U>() / (U(1.0) - cos_theta_max);
+}
+
+template<typename T, typename U=typename detail::component<T>::type>
+T cone(U cos_theta_max, U u1, U u2)
+{
+    T r;
+    cone(cos_theta_max, u1, u2, r[0], r[1], r[2]);
+    return r;
+}
+
+template<typename T, typename V, typename U=typename detail::component<T>::type>
+T cone(U cos_theta_max, const V& u)
+{
+    T r;
+    cone(cos_theta_max, U(u[0]), U(u[1]), r[0], r[1], r[2]);
+    return r;
+}
+
+// Return type is not deduced from the axis so that calls with scalar arguments resolve to the pointer overloads.
+template<typename T, typename A, typename V, typename U=typename detail::component<T>::type>
+T cone(const A& axis, U cos_theta_max, const V& u)
+{
+    const U a[] = { axis[0], axis[1], axis[2] };
+    T r;
+    cone(a, cos_theta_max, U(u[0]), U(u[1]), r[0], r[1], r[2]);
+    return r;
+}
+
+template<typename U>
+void cone(U cos_theta_max, const U* u, U* p)
+{
+    cone(cos_theta_max, u[0], u[1], p[0], p[1], p[2]);
+}
+
+template<typename U>
+void cone(U cos_theta_max, const U* u, U* p, size_t count)
+{
+    detail::warp_batch<2, 3>(u, p, count, [cos_theta_max](const U* ui, U* pi) { cone(cos_theta_max, ui, pi); });
+}
+
+template<typename U, typename V>
+void cone(U cos_theta_max, const soa_buffer<V, 2>& u, const soa_buffer<U, 3>& p, size_t count)
+{
+    detail::warp_batch<2, 3>(u, p, count, [cos_theta_max](const U* ui, U* pi) { cone(cos_theta_max, ui, pi); });
+}
+
+// Basis is built once for the whole batch.
+template<typename U>
+void cone(const U* axis, U cos_theta_max, const U* u, U* p, size_t count)
+{
+    U t[3], b[3];
+    orthonormal_basis(axis, t, b);
+    detail::warp_batch<2, 3>(u, p, count, [&](const U* ui, U* pi) {
+        U local[3];
+        cone(cos_theta_max, ui, local);
+        from_frame(t, b, axis, local, pi);
+    });
+}
+
+template<typename U, typename V>
+void cone(const U* axis, U cos_theta_max, const soa_buffer<V, 2>& u, const soa_buffer<U, 3>& p, size_t count)
+{
+    U t[3], b[3];
+    orthonormal_basis(axis, t, b);
+    detail::warp_batch<2, 3>(u, p, count, [&](const U* ui, U* pi) {
+        U local[3];
+        cone(cos_theta_max, ui, local);
+        from_frame(t, b, axis, local, pi);
+    });
+}
+
+// Uniformly distributed point on spherical cap around +z axis.
+template<typename U>
+void spherical_cap(U radius, U cos_theta_max, U u1, U u2, U& px, U& py, U& pz)
+{
+    cone(cos_theta_max, u1, u2, px, py, pz);
+    px *= radius;
+    py *= radius;
+    pz *= radius;
+}
+
+template<typename U>
+constexpr U spherical_cap_pdf(U radius, U cos_theta_max)
+{
+    U inv_radius_sqr = U(1.0) / (radius * radius);
+    return U(0.5) * detail::inv_pi<U>() * inv_radius_sqr / (U(1.0) - cos_theta_max);
+}
+
+template<typename T, typename U=typename detail::component<T>::type>
+T spherical_cap(U radius, U cos_theta_max, U u1, U u2)
+{
+    T r;
+    spherical_cap(radius, cos_theta_max, u1, u2, r[0], r[1], r[2]);
+    return r;
+}
+
+template<typename T, typename V, typename U=typename detail::component<T>::type>
+T spherical_cap(U radius, U cos_theta_max, const V& u)
+{
+    T r;
+    spherical_cap(radius, cos_theta_max, U(u[0]), U(u[1]), r[0], r[1], r[2]);
+    return r;
+}
+
+template<typename U>
+void spherical_cap(U radius, U cos_theta_max, const U* u, U* p)
+{
+    spherical_cap(radius, cos_theta_max, u[0], u[1], p[0], p[1], p[2]);
+}
+
+template<typename U>
+void spherical_cap(U radius, U cos_theta_max, const U* u, U* p, size_t count)
+{
+    detail::warp_batch<2, 3>(u, p, count, [radius, cos_theta_max](const U* ui, U* pi) { spherical_cap(radius, cos_theta_max, ui, pi); });
+}
+
+template<typename U, typename V>
+void spherical_cap(U radius, U cos_theta_max, const soa_buffer<V, 2>& u, const soa_buffer<U, 3>& p, size_t count)
+{
+    detail::warp_batch<2, 3>(u, p, count, [radius, cos_theta_max](const U* ui, U* pi) { spherical_cap(radius, cos_theta_max, ui, pi); });
+}
+
+} // rsm
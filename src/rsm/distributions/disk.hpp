@@ -32,7 +32,7 @@ template<typename T, typename U=typename detail::component<T>::type>
 T disk(U radius, U u1, U u2)
 {
     T r;
-    disk(radius, u1, u2, r[0], r[1], r[2]);
+    disk(radius, u1, u2, r[0], r[1]);
     return r;
 }
 
@@ -40,14 +40,14 @@ template<typename T, typename V, typename U=typename detail::component<T>::type>
 T disk(U radius, const V& u)
 {
     T r;
-    disk(radius, u[0], u[1], r[0], r[1], r[2]);
+    disk(radius, u[0], u[1], r[0], r[1]);
     return r;
 }
 
 template<typename U>
 void disk(U radius, const U* u, U* p)
 {
-    disk(radius, u[0], u[1], p[0], p[1], p[2]);
+    disk(radius, u[0], u[1], p[0], p[1]);
 }
 
 template<typename U>
@@ -86,7 +86,7 @@ template<typename T, typename U=typename detail::component<T>::type>
 T disk_concentric(U radius, U u1, U u2)
 {
     T r;
-    disk_concentric(radius, u1, u2, r[0], r[1], r[2]);
+    disk_concentric(radius, u1, u2, r[0], r[1]);
     return r;
 }
 
@@ -94,14 +94,14 @@ template<typename T, typename V, typename U=typename detail::component<T>::type>
 T disk_concentric(U radius, const V& u)
 {
     T r;
-    disk_concentric(radius, u[0], u[1], r[0], r[1], r[2]);
+    disk_concentric(radius, u[0], u[1], r[0], r[1]);
     return r;
 }
 
 template<typename U>
 void disk_concentric(U radius, const U* u, U* p)
 {
-    disk_concentric(radius, u[0], u[1], p[0], p[1], p[2]);
+    disk_concentric(radius, u[0], u[1], p[0], p[1]);
 }
 
 } // rsm
@@ -0,0 +1,53 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cmath>
+
+namespace rsm {
+
+// Builds orthonormal basis (t, b, n) from unit vector n without branches on the vector direction.
+// See: T. Duff et al., "Building an Orthonormal Basis, Revisited".
+template<typename U>
+void orthonormal_basis(const U* n, U* t, U* b)
+{
+    const U sign = std::copysign(U(1.0), n[2]);
+    const U a = U(-1.0) / (sign + n[2]);
+    const U c = n[0] * n[1] * a;
+    t[0] = U(1.0) + sign * n[0] * n[0] * a;
+    t[1] = sign * c;
+    t[2] = -sign * n[0];
+    b[0] = c;
+    b[1] = sign + n[1] * n[1] * a;
+    b[2] = -n[1];
+}
+
+// Transforms vector v from local frame (t, b, n) to world space.
+template<typename U>
+void from_frame(const U* t, const U* b, const U* n, const U* v, U* r)
+{
+    const U x = v[0] * t[0] + v[1] * b[0] + v[2] * n[0];
+    const U y = v[0] * t[1] + v[1] * b[1] + v[2] * n[1];
+    const U z = v[0] * t[2] + v[1] * b[2] + v[2] * n[2];
+    r[0] = x;
+    r[1] = y;
+    r[2] = z;
+}
+
+// Transforms world space vector v to local frame (t, b, n).
+template<typename U>
+void to_frame(const U* t, const U* b, const U* n, const U* v, U* r)
+{
+    const U x = v[0] * t[0] + v[1] * t[1] + v[2] * t[2];
+    const U y = v[0] * b[0] + v[1] * b[1] + v[2] * b[2];
+    const U z = v[0] * n[0] + v[1] * n[1] + v[2] * n[2];
+    r[0] = x;
+    r[1] = y;
+    r[2] = z;
+}
+
+} // rsm
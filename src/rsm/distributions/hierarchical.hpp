@@ -0,0 +1,349 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "../detail/common.hpp"
+#include "../detail/memory.hpp"
+#include "../detail/batch.hpp"
+
+namespace rsm {
+
+// Mip pyramid of a 2D weight image used for hierarchical sample warping.
+// Level 0 holds the weights, every coarser level holds sums of 2x2 (or 2x1 for non-square images) texel blocks.
+// Building the pyramid is O(n) and, unlike a 2D CDF table, only texels covering changed weights
+// need to be recomputed, so maps changing every frame can be rebuilt cheaply.
+// See: P. Clarberg et al., "Wavelet Importance Sampling: Efficiently Evaluating Products of Complex Functions".
+template<typename U>
+class importance_map
+{
+public:
+    static constexpr unsigned int max_levels = 32;
+
+    explicit importance_map(const allocator_t& allocator=detail::default_allocator())
+        : m_allocator(allocator)
+        , m_data(nullptr)
+        , m_num_levels(0)
+    {}
+
+    importance_map(const importance_map&) = delete;
+    importance_map& operator=(const importance_map&) = delete;
+
+    importance_map(importance_map&& other)
+        : m_allocator(other.m_allocator)
+        , m_data(other.m_data)
+        , m_num_levels(other.m_num_levels)
+        , m_offset(other.m_offset)
+        , m_width(other.m_width)
+        , m_height(other.m_height)
+    {
+        other.m_data = nullptr;
+        other.m_num_levels = 0;
+    }
+
+    importance_map& operator=(importance_map&& other)
+    {
+        if(this != &other) {
+            release();
+            m_allocator = other.m_allocator;
+            m_data = other.m_data;
+            m_num_levels = other.m_num_levels;
+            m_offset = other.m_offset;
+            m_width = other.m_width;
+            m_height = other.m_height;
+            other.m_data = nullptr;
+            other.m_num_levels = 0;
+        }
+        return *this;
+    }
+
+    ~importance_map()
+    {
+        release();
+    }
+
+    // Allocates the pyramid for a width x height image; both dimensions must be powers of two.
+    // All weights are initialized to zero. Returns false if allocation fails.
+    bool initialize(uint32_t width, uint32_t height)
+    {
+        assert(width > 0 && (width & (width - 1)) == 0);
+        assert(height > 0 && (height & (height - 1)) == 0);
+
+        release();
+
+        size_t num_texels = 0;
+        unsigned int num_levels = 0;
+        for(uint32_t w=width, h=height;; w = std::max(w >> 1, 1u), h = std::max(h >> 1, 1u)) {
+            assert(num_levels < max_levels);
+            m_offset[num_levels] = num_texels;
+            m_width[num_levels] = w;
+            m_height[num_levels] = h;
+            num_texels += size_t(w) * h;
+            ++num_levels;
+            if(w == 1 && h == 1) {
+                break;
+            }
+        }
+
+        m_data = detail::alloc<U>(m_allocator, num_texels);
+        if(!m_data) {
+            return false;
+        }
+        m_num_levels = num_levels;
+        std::fill(m_data, m_data + num_texels, U(0.0));
+        return true;
+    }
+
+    void release()
+    {
+        if(m_data) {
+            detail::free(m_allocator, m_data);
+        }
+        m_num_levels = 0;
+    }
+
+    // Level 0 weights stored row by row; call rebuild() after modifying them.
+    U* weights()
+    {
+        assert(m_data);
+        return m_data;
+    }
+
+    const U* weights() const
+    {
+        assert(m_data);
+        return m_data;
+    }
+
+    // Copies weights from an image with given row pitch (in elements; 0 means tightly packed) and rebuilds the pyramid.
+    void set_weights(const U* image, size_t pitch=0)
+    {
+        assert(m_data && image);
+        const uint32_t w = width();
+        const uint32_t h = height();
+        if(pitch == 0) {
+            pitch = w;
+        }
+        for(uint32_t y=0; y<h; ++y) {
+            std::copy(image + y * pitch, image + y * pitch + w, m_data + size_t(y) * w);
+        }
+        rebuild();
+    }
+
+    void rebuild()
+    {
+        rebuild(0, 0, width(), height());
+    }
+
+    // Recomputes pyramid texels covering level 0 region [x0, x1) x [y0, y1) after its weights have changed.
+    void rebuild(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1)
+    {
+        assert(m_data);
+        assert(x0 <= x1 && x1 <= width() && y0 <= y1 && y1 <= height());
+        if(x0 == x1 || y0 == y1) {
+            return;
+        }
+        for(unsigned int level=1; level<m_num_levels; ++level) {
+            const bool split_x = m_width[level-1] > m_width[level];
+            const bool split_y = m_height[level-1] > m_height[level];
+            if(split_x) {
+                x0 >>= 1;
+                x1 = ((x1 - 1) >> 1) + 1;
+            }
+            if(split_y) {
+                y0 >>= 1;
+                y1 = ((y1 - 1) >> 1) + 1;
+            }
+            const U* child = m_data + m_offset[level-1];
+            U* parent = m_data + m_offset[level];
+            const size_t child_width = m_width[level-1];
+            const size_t parent_width = m_width[level];
+            for(uint32_t y=y0; y<y1; ++y) {
+                const U* row0 = child + (split_y ? 2*y : y) * child_width;
+                const U* row1 = split_y ? row0 + child_width : nullptr;
+                for(uint32_t x=x0; x<x1; ++x) {
+                    const uint32_t cx = split_x ? 2*x : x;
+                    U sum = row0[cx];
+                    if(split_x) {
+                        sum += row0[cx+1];
+                    }
+                    if(row1) {
+                        sum += row1[cx];
+                        if(split_x) {
+                            sum += row1[cx+1];
+                        }
+                    }
+                    parent[y * parent_width + x] = sum;
+                }
+            }
+        }
+    }
+
+    uint32_t width(unsigned int level=0) const
+    {
+        assert(level < m_num_levels);
+        return m_width[level];
+    }
+
+    uint32_t height(unsigned int level=0) const
+    {
+        assert(level < m_num_levels);
+        return m_height[level];
+    }
+
+    unsigned int num_levels() const
+    {
+        return m_num_levels;
+    }
+
+    U texel(unsigned int level, uint32_t x, uint32_t y) const
+    {
+        assert(level < m_num_levels && x < m_width[level] && y < m_height[level]);
+        return m_data[m_offset[level] + size_t(y) * m_width[level] + x];
+    }
+
+    U total_weight() const
+    {
+        assert(m_data);
+        return m_data[m_offset[m_num_levels-1]];
+    }
+
+private:
+    allocator_t m_allocator;
+    U* m_data;
+    unsigned int m_num_levels;
+    std::array<size_t, max_levels> m_offset;
+    std::array<uint32_t, max_levels> m_width;
+    std::array<uint32_t, max_levels> m_height;
+};
+
+namespace detail {
+
+// Picks one of two children with probability proportional to their weights and rescales the variate
+// so it's uniformly distributed again within the chosen child; empty nodes are split evenly.
+template<typename U>
+uint32_t hierarchical_choose(U w0, U w1, U& u)
+{
+    const U sum = w0 + w1;
+    const U p = (sum > U(0.0)) ? w0 / sum : U(0.5);
+    if(u < p) {
+        u = detail::variate(u / p);
+        return 0;
+    }
+    else {
+        u = detail::variate((u - p) / (U(1.0) - p));
+        return 1;
+    }
+}
+
+} // detail
+
+// Warps (u1, u2) to a point in [0..1)^2 distributed proportionally to the weights of an importance map.
+// Variates are rescaled at every level instead of being consumed, which preserves stratification of the input.
+template<typename U>
+void hierarchical(const importance_map<U>& map, U u1, U u2, U& px, U& py)
+{
+    uint32_t x = 0;
+    uint32_t y = 0;
+    for(unsigned int level=map.num_levels()-1; level>0; --level) {
+        const unsigned int child = level - 1;
+        const bool split_x = map.width(child) > map.width(level);
+        const bool split_y = map.height(child) > map.height(level);
+        x = split_x ? 2*x : x;
+        y = split_y ? 2*y : y;
+        if(split_x) {
+            U left = map.texel(child, x, y);
+            U right = map.texel(child, x+1, y);
+            if(split_y) {
+                left += map.texel(child, x, y+1);
+                right += map.texel(child, x+1, y+1);
+            }
+            x += detail::hierarchical_choose(left, right, u1);
+        }
+        if(split_y) {
+            y += detail::hierarchical_choose(map.texel(child, x, y), map.texel(child, x, y+1), u2);
+        }
+    }
+    px = detail::variate((x + u1) / U(map.width()));
+    py = detail::variate((y + u2) / U(map.height()));
+}
+
+// Density with respect to area of the unit square; uniform if all weights are zero.
+template<typename U>
+U hierarchical_pdf(const importance_map<U>& map, U px, U py)
+{
+    const uint32_t w = map.width();
+    const uint32_t h = map.height();
+    const uint32_t x = std::min(static_cast<uint32_t>(std::max(px, U(0.0)) * w), w - 1);
+    const uint32_t y = std::min(static_cast<uint32_t>(std::max(py, U(0.0)) * h), h - 1);
+    const U total = map.total_weight();
+    return (total > U(0.0)) ? map.texel(0, x, y) * (U(w) * U(h)) / total : U(1.0);
+}
+
+template<typename T, typename U=typename detail::component<T>::type>
+T hierarchical(const importance_map<U>& map, U u1, U u2)
+{
+    T r;
+    hierarchical(map, u1, u2, r[0], r[1]);
+    return r;
+}
+
+template<typename T, typename V, typename U=typename detail::component<T>::type>
+T hierarchical(const importance_map<U>& map, const V& u)
+{
+    T r;
+    hierarchical(map, U(u[0]), U(u[1]), r[0], r[1]);
+    return r;
+}
+
+template<typename T, typename U>
+U hierarchical_pdf(const importance_map<U>& map, const T& p)
+{
+    return hierarchical_pdf(map, U(p[0]), U(p[1]));
+}
+
+template<typename U>
+void hierarchical(const importance_map<U>& map, const U* u, U* p)
+{
+    hierarchical(map, u[0], u[1], p[0], p[1]);
+}
+
+template<typename U>
+void hierarchical(const importance_map<U>& map, const U* u, U* p, size_t count)
+{
+    detail::warp_batch<2, 2>(u, p, count, [&map](const U* ui, U* pi) { hierarchical(map, ui, pi); });
+}
+
+template<typename U, typename V>
+void hierarchical(const importance_map<U>& map, const soa_buffer<V, 2>& u, const soa_buffer<U, 2>& p, size_t count)
+{
+    detail::warp_batch<2, 2>(u, p, count, [&map](const U* ui, U* pi) { hierarchical(map, ui, pi); });
+}
+
+template<typename U>
+void hierarchical_pdf(const importance_map<U>& map, const U* p, U* pdf, size_t count)
+{
+    for(size_t i=0; i<count; ++i) {
+        pdf[i] = hierarchical_pdf(map, p[2*i], p[2*i+1]);
+    }
+}
+
+template<typename U>
+void hierarchical_pdf(const importance_map<U>& map, const soa_buffer<U, 2>& p, U* pdf, size_t count)
+{
+    for(size_t i=0; i<count; ++i) {
+        pdf[i] = hierarchical_pdf(map, p.data[0][i], p.data[1][i]);
+    }
+}
+
+} // rsm
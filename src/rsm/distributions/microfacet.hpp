@@ -0,0 +1,350 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+
+#include "../detail/common.hpp"
+#include "../detail/vector.hpp"
+#include "../layout.hpp"
+
+namespace rsm {
+
+// Microfacet distributions of visible normals (VNDF).
+// All directions are expressed in local shading frame with z axis along the macrosurface normal.
+// Visible normals are sampled as seen from direction wi (pointing away from the surface);
+// alpha_x and alpha_y are anisotropic roughness parameters along x and y axes.
+
+namespace detail {
+
+// Inverse error function approximation.
+// See: M. Giles, "Approximating the erfinv function".
+template<typename U>
+U erfinv(U x)
+{
+    x = std::max(U(-0.99999), std::min(U(0.99999), x));
+    U w = -std::log((U(1.0) - x) * (U(1.0) + x));
+    U p;
+    if(w < U(5.0)) {
+        w = w - U(2.5);
+        p = U(2.81022636e-08);
+        p = U(3.43273939e-07) + p * w;
+        p = U(-3.5233877e-06) + p * w;
+        p = U(-4.39150654e-06) + p * w;
+        p = U(0.00021858087) + p * w;
+        p = U(-0.00125372503) + p * w;
+        p = U(-0.00417768164) + p * w;
+        p = U(0.246640727) + p * w;
+        p = U(1.50140941) + p * w;
+    }
+    else {
+        w = std::sqrt(w) - U(3.0);
+        p = U(-0.000200214257);
+        p = U(0.000100950558) + p * w;
+        p = U(0.00134934322) + p * w;
+        p = U(-0.00367342844) + p * w;
+        p = U(0.00573950773) + p * w;
+        p = U(-0.0076224613) + p * w;
+        p = U(0.00943887047) + p * w;
+        p = U(1.00167406) + p * w;
+        p = U(2.83297682) + p * w;
+    }
+    return p * x;
+}
+
+// Samples slopes of visible Beckmann microfacets for unit roughness.
+// Uses numerical inversion of the CDF which is continuous in sample values (unlike the original fit).
+template<typename U>
+void beckmann_sample11(U cos_theta, U u1, U u2, U& slope_x, U& slope_y)
+{
+    if(cos_theta > U(0.9999)) {
+        const U r = std::sqrt(-std::log(U(1.0) - u1));
+        const U phi = U(2.0) * pi<U>() * u2;
+        slope_x = r * std::cos(phi);
+        slope_y = r * std::sin(phi);
+        return;
+    }
+
+    const U sin_theta = std::sqrt(std::max(U(0.0), U(1.0) - cos_theta * cos_theta));
+    const U tan_theta = sin_theta / cos_theta;
+    const U cot_theta = U(1.0) / tan_theta;
+    const U inv_sqrt_pi = U(1.0) / std::sqrt(pi<U>());
+
+    // Search interval parametrized in erf() domain.
+    U a = U(-1.0);
+    U c = std::erf(cot_theta);
+    const U sample_x = std::max(u1, U(1e-6));
+
+    // Initial guess from an inverse of a fitted approximation.
+    const U theta = std::acos(cos_theta);
+    const U fit = U(1.0) + theta * (U(-0.876) + theta * (U(0.4265) - U(0.0594) * theta));
+    U b = c - (U(1.0) + c) * std::pow(U(1.0) - sample_x, fit);
+
+    const U normalization = U(1.0) / (U(1.0) + c + inv_sqrt_pi * tan_theta * std::exp(-cot_theta * cot_theta));
+    for(int it=1; it<10; ++it) {
+        // Bisection fallback; also catches NaNs.
+        if(!(b >= a && b <= c)) {
+            b = U(0.5) * (a + c);
+        }
+        const U inv_erf = erfinv(b);
+        const U value = normalization * (U(1.0) + b + inv_sqrt_pi * tan_theta * std::exp(-inv_erf * inv_erf)) - sample_x;
+        const U derivative = normalization * (U(1.0) - inv_erf * tan_theta);
+        if(std::abs(value) < U(1e-5)) {
+            break;
+        }
+        if(value > U(0.0)) {
+            c = b;
+        }
+        else {
+            a = b;
+        }
+        b -= value / derivative;
+    }
+    slope_x = erfinv(b);
+    slope_y = erfinv(U(2.0) * std::max(u2, U(1e-6)) - U(1.0));
+}
+
+} // detail
+
+template<typename U>
+U ggx_d(const U* h, U alpha_x, U alpha_y)
+{
+    const U x = h[0] / alpha_x;
+    const U y = h[1] / alpha_y;
+    const U t = x * x + y * y + h[2] * h[2];
+    return (h[2] > U(0.0)) ? U(1.0) / (detail::pi<U>() * alpha_x * alpha_y * t * t) : U(0.0);
+}
+
+template<typename U>
+U ggx_lambda(const U* w, U alpha_x, U alpha_y)
+{
+    const U x = alpha_x * w[0];
+    const U y = alpha_y * w[1];
+    return U(0.5) * (std::sqrt(U(1.0) + (x * x + y * y) / (w[2] * w[2])) - U(1.0));
+}
+
+template<typename U>
+U ggx_g1(const U* w, U alpha_x, U alpha_y)
+{
+    return U(1.0) / (U(1.0) + ggx_lambda(w, alpha_x, alpha_y));
+}
+
+template<typename U>
+U beckmann_d(const U* h, U alpha_x, U alpha_y)
+{
+    if(h[2] <= U(0.0)) {
+        return U(0.0);
+    }
+    const U x = h[0] / alpha_x;
+    const U y = h[1] / alpha_y;
+    const U cos2_theta = h[2] * h[2];
+    return std::exp(-(x * x + y * y) / cos2_theta) / (detail::pi<U>() * alpha_x * alpha_y * cos2_theta * cos2_theta);
+}
+
+template<typename U>
+U beckmann_lambda(const U* w, U alpha_x, U alpha_y)
+{
+    const U x = alpha_x * w[0];
+    const U y = alpha_y * w[1];
+    const U r = std::sqrt(x * x + y * y);
+    if(r == U(0.0)) {
+        return U(0.0);
+    }
+    const U a = std::abs(w[2]) / r;
+    return U(0.5) * (std::erf(a) - U(1.0)) + std::exp(-a * a) / (U(2.0) * a * std::sqrt(detail::pi<U>()));
+}
+
+template<typename U>
+U beckmann_g1(const U* w, U alpha_x, U alpha_y)
+{
+    return U(1.0) / (U(1.0) + beckmann_lambda(w, alpha_x, alpha_y));
+}
+
+// GGX visible normal sampling by sampling a spherical cap in the hemisphere configuration.
+// See: J. Dupuy, A. Benyoub, "Sampling Visible GGX Normals with Spherical Caps".
+template<typename U>
+void ggx_vndf(const U* wi, U alpha_x, U alpha_y, U u1, U u2, U& hx, U& hy, U& hz)
+{
+    // Directions below the surface are handled by symmetry.
+    const U sign = (wi[2] < U(0.0)) ? U(-1.0) : U(1.0);
+    U wi_std[] = { sign * wi[0] * alpha_x, sign * wi[1] * alpha_y, sign * wi[2] };
+    detail::normalize3(wi_std);
+
+    const U phi = U(2.0) * detail::pi<U>() * u1;
+    const U z = (U(1.0) - u2) * (U(1.0) + wi_std[2]) - wi_std[2];
+    const U sin_theta = std::sqrt(std::max(U(0.0), U(1.0) - z * z));
+    U h[] = {
+        (sin_theta * std::cos(phi) + wi_std[0]) * alpha_x,
+        (sin_theta * std::sin(phi) + wi_std[1]) * alpha_y,
+        z + wi_std[2],
+    };
+    detail::normalize3(h);
+    hx = sign * h[0];
+    hy = sign * h[1];
+    hz = sign * h[2];
+}
+
+// Density of visible normal h with respect to solid angle: G1(wi) * max(0, wi.h) * D(h) / wi.z.
+template<typename U>
+U ggx_vndf_pdf(const U* wi, const U* h, U alpha_x, U alpha_y)
+{
+    const U sign = (wi[2] < U(0.0)) ? U(-1.0) : U(1.0);
+    const U hs[] = { sign * h[0], sign * h[1], sign * h[2] };
+    const U cos_theta = std::abs(wi[2]);
+    const U wi_dot_h = std::max(U(0.0), detail::dot3(wi, h));
+    return (cos_theta > U(0.0)) ? ggx_g1(wi, alpha_x, alpha_y) * wi_dot_h * ggx_d(hs, alpha_x, alpha_y) / cos_theta : U(0.0);
+}
+
+// Beckmann visible normal sampling by stretching to unit roughness and sampling visible slopes.
+// See: E. Heitz, E. d'Eon, "Importance Sampling Microfacet-Based BSDFs using the Distribution of Visible Normals".
+template<typename U>
+void beckmann_vndf(const U* wi, U alpha_x, U alpha_y, U u1, U u2, U& hx, U& hy, U& hz)
+{
+    const U sign = (wi[2] < U(0.0)) ? U(-1.0) : U(1.0);
+    U wi_stretched[] = { sign * wi[0] * alpha_x, sign * wi[1] * alpha_y, sign * wi[2] };
+    detail::normalize3(wi_stretched);
+
+    U slope_x, slope_y;
+    detail::beckmann_sample11(wi_stretched[2], u1, u2, slope_x, slope_y);
+
+    // Rotate by azimuth of wi and unstretch.
+    const U sin_theta = std::sqrt(std::max(U(0.0), U(1.0) - wi_stretched[2] * wi_stretched[2]));
+    const U cos_phi = (sin_theta > U(0.0)) ? std::max(U(-1.0), std::min(U(1.0), wi_stretched[0] / sin_theta)) : U(1.0);
+    const U sin_phi = (sin_theta > U(0.0)) ? std::max(U(-1.0), std::min(U(1.0), wi_stretched[1] / sin_theta)) : U(0.0);
+    const U sx = alpha_x * (cos_phi * slope_x - sin_phi * slope_y);
+    const U sy = alpha_y * (sin_phi * slope_x + cos_phi * slope_y);
+
+    U h[] = { -sx, -sy, U(1.0) };
+    detail::normalize3(h);
+    hx = sign * h[0];
+    hy = sign * h[1];
+    hz = sign * h[2];
+}
+
+template<typename U>
+U beckmann_vndf_pdf(const U* wi, const U* h, U alpha_x, U alpha_y)
+{
+    const U sign = (wi[2] < U(0.0)) ? U(-1.0) : U(1.0);
+    const U hs[] = { sign * h[0], sign * h[1], sign * h[2] };
+    const U cos_theta = std::abs(wi[2]);
+    const U wi_dot_h = std::max(U(0.0), detail::dot3(wi, h));
+    return (cos_theta > U(0.0)) ? beckmann_g1(wi, alpha_x, alpha_y) * wi_dot_h * beckmann_d(hs, alpha_x, alpha_y) / cos_theta : U(0.0);
+}
+
+template<typename T, typename U=typename detail::component<T>::type>
+T ggx_vndf(const T& wi, U alpha_x, U alpha_y, U u1, U u2)
+{
+    const U w[] = { wi[0], wi[1], wi[2] };
+    T r;
+    ggx_vndf(w, alpha_x, alpha_y, u1, u2, r[0], r[1], r[2]);
+    return r;
+}
+
+template<typename T, typename V, typename U=typename detail::component<T>::type>
+T ggx_vndf(const T& wi, U alpha_x, U alpha_y, const V& u)
+{
+    return ggx_vndf(wi, alpha_x, alpha_y, U(u[0]), U(u[1]));
+}
+
+template<typename T, typename U=typename detail::component<T>::type>
+U ggx_vndf_pdf(const T& wi, const T& h, U alpha_x, U alpha_y)
+{
+    const U w[] = { wi[0], wi[1], wi[2] };
+    const U m[] = { h[0], h[1], h[2] };
+    return ggx_vndf_pdf(w, m, alpha_x, alpha_y);
+}
+
+template<typename U>
+void ggx_vndf(const U* wi, U alpha_x, U alpha_y, const U* u, U* h)
+{
+    ggx_vndf(wi, alpha_x, alpha_y, u[0], u[1], h[0], h[1], h[2]);
+}
+
+template<typename T, typename U=typename detail::component<T>::type>
+T beckmann_vndf(const T& wi, U alpha_x, U alpha_y, U u1, U u2)
+{
+    const U w[] = { wi[0], wi[1], wi[2] };
+    T r;
+    beckmann_vndf(w, alpha_x, alpha_y, u1, u2, r[0], r[1], r[2]);
+    return r;
+}
+
+template<typename T, typename V, typename U=typename detail::component<T>::type>
+T beckmann_vndf(const T& wi, U alpha_x, U alpha_y, const V& u)
+{
+    return beckmann_vndf(wi, alpha_x, alpha_y, U(u[0]), U(u[1]));
+}
+
+template<typename T, typename U=typename detail::component<T>::type>
+U beckmann_vndf_pdf(const T& wi, const T& h, U alpha_x, U alpha_y)
+{
+    const U w[] = { wi[0], wi[1], wi[2] };
+    const U m[] = { h[0], h[1], h[2] };
+    return beckmann_vndf_pdf(w, m, alpha_x, alpha_y);
+}
+
+template<typename U>
+void beckmann_vndf(const U* wi, U alpha_x, U alpha_y, const U* u, U* h)
+{
+    beckmann_vndf(wi, alpha_x, alpha_y, u[0], u[1], h[0], h[1], h[2]);
+}
+
+// Batch variants take a separate view direction for every sample (interleaved or SoA).
+
+template<typename U>
+void ggx_vndf(const U* wi, U alpha_x, U alpha_y, const U* u, U* h, size_t count)
+{
+    for(size_t i=0; i<count; ++i) {
+        ggx_vndf(wi + 3 * i, alpha_x, alpha_y, u[2 * i], u[2 * i + 1], h[3 * i], h[3 * i + 1], h[3 * i + 2]);
+    }
+}
+
+template<typename U, typename V>
+void ggx_vndf(const soa_buffer<V, 3>& wi, U alpha_x, U alpha_y, const soa_buffer<V, 2>& u, const soa_buffer<U, 3>& h, size_t count)
+{
+    for(size_t i=0; i<count; ++i) {
+        const U w[] = { wi.data[0][i], wi.data[1][i], wi.data[2][i] };
+        ggx_vndf(w, alpha_x, alpha_y, U(u.data[0][i]), U(u.data[1][i]), h.data[0][i], h.data[1][i], h.data[2][i]);
+    }
+}
+
+template<typename U>
+void ggx_vndf_pdf(const U* wi, const U* h, U alpha_x, U alpha_y, U* pdf, size_t count)
+{
+    for(size_t i=0; i<count; ++i) {
+        pdf[i] = ggx_vndf_pdf(wi + 3 * i, h + 3 * i, alpha_x, alpha_y);
+    }
+}
+
+template<typename U>
+void beckmann_vndf(const U* wi, U alpha_x, U alpha_y, const U* u, U* h, size_t count)
+{
+    for(size_t i=0; i<count; ++i) {
+        beckmann_vndf(wi + 3 * i, alpha_x, alpha_y, u[2 * i], u[2 * i + 1], h[3 * i], h[3 * i + 1], h[3 * i + 2]);
+    }
+}
+
+template<typename U, typename V>
+void beckmann_vndf(const soa_buffer<V, 3>& wi, U alpha_x, U alpha_y, const soa_buffer<V, 2>& u, const soa_buffer<U, 3>& h, size_t count)
+{
+    for(size_t i=0; i<count; ++i) {
+        const U w[] = { wi.data[0][i], wi.data[1][i], wi.data[2][i] };
+        beckmann_vndf(w, alpha_x, alpha_y, U(u.data[0][i]), U(u.data[1][i]), h.data[0][i], h.data[1][i], h.data[2][i]);
+    }
+}
+
+template<typename U>
+void beckmann_vndf_pdf(const U* wi, const U* h, U alpha_x, U alpha_y, U* pdf, size_t count)
+{
+    for(size_t i=0; i<count; ++i) {
+        pdf[i] = beckmann_vndf_pdf(wi + 3 * i, h + 3 * i, alpha_x, alpha_y);
+    }
+}
+
+} // rsm
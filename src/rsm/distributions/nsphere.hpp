@@ -0,0 +1,224 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+
+#include "../detail/common.hpp"
+#include "../detail/batch.hpp"
+#include "simplex.hpp"
+
+namespace rsm {
+namespace detail {
+
+// Volume of N-dimensional unit ball: V(N) = 2pi/N * V(N-2).
+template<typename U>
+constexpr U nball_volume(unsigned int N)
+{
+    U volume = (N % 2 == 0) ? U(1.0) : U(2.0);
+    for(unsigned int n=(N % 2 == 0) ? 2 : 3; n<=N; n += 2) {
+        volume *= U(2.0) * pi<U>() / U(n);
+    }
+    return volume;
+}
+
+// Inverse CDF of symmetric Beta(m, m) distribution for integer m, found with safeguarded Newton iteration.
+// CDF is evaluated as P(Binomial(2m-1, w) >= m) so it's exact up to rounding; computed in double precision.
+inline double beta_symmetric_inverse(unsigned int m, double u)
+{
+    if(m == 1 || u <= 0.0) {
+        return u;
+    }
+    const bool mirror = (u > 0.5);
+    u = mirror ? 1.0 - u : u;
+
+    const unsigned int n = 2*m - 1;
+    double lo = 0.0;
+    double hi = 0.5;
+    // CDF behaves as c * w^m near zero and is equal to 0.5 at w=0.5.
+    double w = 0.5 * std::pow(2.0 * u, 1.0 / m);
+    for(unsigned int iteration=0; iteration<64; ++iteration) {
+        // First term of the binomial tail C(n,m) * w^m * (1-w)^(m-1); factors are interleaved to avoid overflow.
+        double term = 1.0;
+        for(unsigned int k=1; k<=m; ++k) {
+            term *= double(m - 1 + k) / double(k) * w;
+            if(k < m) {
+                term *= 1.0 - w;
+            }
+        }
+        const double pdf = term * m / w;
+        double cdf = 0.0;
+        const double ratio = w / (1.0 - w);
+        for(unsigned int j=m; j<=n; ++j) {
+            cdf += term;
+            term *= double(n - j) / double(j + 1) * ratio;
+        }
+
+        const double f = cdf - u;
+        if(f < 0.0) {
+            lo = w;
+        }
+        else {
+            hi = w;
+        }
+        double next_w = w - f / pdf;
+        if(!(next_w > lo && next_w < hi)) {
+            next_w = 0.5 * (lo + hi);
+        }
+        const bool converged = std::abs(next_w - w) <= 1e-15 * w;
+        w = next_w;
+        if(converged) {
+            break;
+        }
+    }
+    return mirror ? 1.0 - w : w;
+}
+
+// Uniform point on unit sphere in R^N for even N=2m from N-1 variates: squared norms of the m coordinate pairs
+// are uniformly distributed on a simplex (m-1 variates) and every pair gets a uniform angle (m variates).
+template<unsigned int N, typename U>
+void nsphere_unit(const U* u, U* p, std::true_type)
+{
+    constexpr unsigned int M = N / 2;
+
+    U weight[M];
+    simplex_coordinates<M-1>(u, weight);
+    U remaining = U(1.0);
+    for(unsigned int i=0; i<M-1; ++i) {
+        remaining -= weight[i];
+    }
+    weight[M-1] = std::max(remaining, U(0.0));
+
+    for(unsigned int i=0; i<M; ++i) {
+        const U r = std::sqrt(weight[i]);
+        const U phi = U(2.0) * pi<U>() * u[M-1+i];
+        p[2*i]   = r * std::cos(phi);
+        p[2*i+1] = r * std::sin(phi);
+    }
+}
+
+// Odd N=2m+1: last coordinate z is distributed so that (1+z)/2 follows Beta(m, m) (uniform for N=3, as in Archimedes'
+// theorem) and the remaining coordinates are a point on sphere in R^(N-1) scaled by sqrt(1-z^2).
+template<unsigned int N, typename U>
+void nsphere_unit(const U* u, U* p, std::false_type)
+{
+    const U w = U(beta_symmetric_inverse(N / 2, double(u[0])));
+    const U z = U(2.0) * w - U(1.0);
+    const U r = std::sqrt(std::max(U(1.0) - z * z, U(0.0)));
+    nsphere_unit<N-1>(u + 1, p, std::true_type{});
+    for(unsigned int i=0; i<N-1; ++i) {
+        p[i] *= r;
+    }
+    p[N-1] = z;
+}
+
+} // detail
+
+// Uniformly distributed point on sphere of given radius in R^N from N-1 variates.
+// Unlike normalizing a vector of normal variates no dimension is wasted so QMC input keeps its structure.
+template<unsigned int N, typename U>
+void nsphere(U radius, const U* u, U* p)
+{
+    static_assert(N > 1, "Number of dimensions must be greater than one");
+
+    detail::nsphere_unit<N>(u, p, std::integral_constant<bool, N % 2 == 0>{});
+    for(unsigned int i=0; i<N; ++i) {
+        p[i] *= radius;
+    }
+}
+
+template<unsigned int N, typename U>
+U nsphere_pdf(U radius)
+{
+    static_assert(N > 1, "Number of dimensions must be greater than one");
+
+    const U area = U(N) * detail::nball_volume<U>(N) * std::pow(radius, U(N - 1));
+    return U(1.0) / area;
+}
+
+// Uniformly distributed point in ball of given radius in R^N from N variates.
+template<unsigned int N, typename U>
+void nball(U radius, const U* u, U* p)
+{
+    static_assert(N > 1, "Number of dimensions must be greater than one");
+
+    const U r = radius * std::pow(u[N-1], U(1.0) / U(N));
+    detail::nsphere_unit<N>(u, p, std::integral_constant<bool, N % 2 == 0>{});
+    for(unsigned int i=0; i<N; ++i) {
+        p[i] *= r;
+    }
+}
+
+template<unsigned int N, typename U>
+U nball_pdf(U radius)
+{
+    static_assert(N > 1, "Number of dimensions must be greater than one");
+
+    const U volume = detail::nball_volume<U>(N) * std::pow(radius, U(N));
+    return U(1.0) / volume;
+}
+
+template<unsigned int N, typename T, typename V, typename U=typename detail::component<T>::type>
+T nsphere(U radius, const V& u)
+{
+    U ui[N-1];
+    U pi[N];
+    for(unsigned int i=0; i<N-1; ++i) {
+        ui[i] = u[i];
+    }
+    nsphere<N>(radius, static_cast<const U*>(ui), pi);
+    T p;
+    for(unsigned int i=0; i<N; ++i) {
+        p[i] = pi[i];
+    }
+    return p;
+}
+
+template<unsigned int N, typename T, typename V, typename U=typename detail::component<T>::type>
+T nball(U radius, const V& u)
+{
+    U ui[N];
+    U pi[N];
+    for(unsigned int i=0; i<N; ++i) {
+        ui[i] = u[i];
+    }
+    nball<N>(radius, static_cast<const U*>(ui), pi);
+    T p;
+    for(unsigned int i=0; i<N; ++i) {
+        p[i] = pi[i];
+    }
+    return p;
+}
+
+template<unsigned int N, typename U>
+void nsphere(U radius, const U* u, U* p, size_t count)
+{
+    detail::warp_batch<N-1, N>(u, p, count, [radius](const U* ui, U* pi) { nsphere<N>(radius, ui, pi); });
+}
+
+template<unsigned int N, typename U, typename V>
+void nsphere(U radius, const soa_buffer<V, N-1>& u, const soa_buffer<U, N>& p, size_t count)
+{
+    detail::warp_batch<N-1, N>(u, p, count, [radius](const U* ui, U* pi) { nsphere<N>(radius, ui, pi); });
+}
+
+template<unsigned int N, typename U>
+void nball(U radius, const U* u, U* p, size_t count)
+{
+    detail::warp_batch<N, N>(u, p, count, [radius](const U* ui, U* pi) { nball<N>(radius, ui, pi); });
+}
+
+template<unsigned int N, typename U, typename V>
+void nball(U radius, const soa_buffer<V, N>& u, const soa_buffer<U, N>& p, size_t count)
+{
+    detail::warp_batch<N, N>(u, p, count, [radius](const U* ui, U* pi) { nball<N>(radius, ui, pi); });
+}
+
+} // rsm
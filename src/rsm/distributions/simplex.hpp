@@ -0,0 +1,88 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cmath>
+
+#include "../detail/common.hpp"
+#include "../detail/batch.hpp"
+
+namespace rsm {
+namespace detail {
+
+// Sequential conditional inversion: given the mass left by previous coordinates each coordinate
+// is distributed as Beta(1, k) scaled by that mass, where k is the number of coordinates left.
+// Every output coordinate depends monotonically on a single input variate so no dimensions are wasted
+// and stratification of QMC inputs carries over. Valid for N=0 (no output).
+template<unsigned int N, typename U>
+void simplex_coordinates(const U* u, U* p)
+{
+    U remaining = U(1.0);
+    for(unsigned int i=0; i<N; ++i) {
+        const unsigned int k = N - i;
+        const U fraction = (k == 1) ? u[i] : -std::expm1(std::log1p(-u[i]) / U(k));
+        p[i] = remaining * fraction;
+        remaining -= p[i];
+    }
+}
+
+} // detail
+
+// Uniformly distributed point in N-dimensional standard simplex {p : p[i] >= 0, sum(p) <= 1} from N variates.
+// Barycentric coordinates of the point are (p[0], ..., p[N-1], 1 - sum(p)).
+template<unsigned int N, typename U>
+void simplex(const U* u, U* p)
+{
+    static_assert(N > 0, "Number of dimensions must be greater than zero");
+    detail::simplex_coordinates<N>(u, p);
+}
+
+template<unsigned int N, typename U>
+constexpr U simplex_pdf()
+{
+    static_assert(N > 0, "Number of dimensions must be greater than zero");
+
+    U factorial = U(1.0);
+    for(unsigned int i=2; i<=N; ++i) {
+        factorial *= U(i);
+    }
+    return factorial;
+}
+
+template<unsigned int N, typename T, typename V>
+T simplex(const V& u)
+{
+    static_assert(N > 0, "Number of dimensions must be greater than zero");
+
+    using U = typename detail::component<T>::type;
+    U ui[N];
+    U pi[N];
+    for(unsigned int i=0; i<N; ++i) {
+        ui[i] = u[i];
+    }
+    detail::simplex_coordinates<N>(static_cast<const U*>(ui), pi);
+    T p;
+    for(unsigned int i=0; i<N; ++i) {
+        p[i] = pi[i];
+    }
+    return p;
+}
+
+template<unsigned int N, typename U>
+void simplex(const U* u, U* p, size_t count)
+{
+    detail::warp_batch<N, N>(u, p, count, [](const U* ui, U* pi) { simplex<N>(ui, pi); });
+}
+
+template<unsigned int N, typename U, typename V>
+void simplex(const soa_buffer<V, N>& u, const soa_buffer<U, N>& p, size_t count)
+{
+    detail::warp_batch<N, N>(u, p, count, [](const U* ui, U* pi) { simplex<N>(ui, pi); });
+}
+
+} // rsm
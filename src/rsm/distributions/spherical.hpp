@@ -0,0 +1,279 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+#include "../detail/common.hpp"
+#include "../detail/vector.hpp"
+#include "../detail/batch.hpp"
+
+namespace rsm {
+
+namespace detail {
+
+template<typename U>
+U clamp_unit(U x)
+{
+    return std::max(U(-1.0), std::min(U(1.0), x));
+}
+
+// Component of v orthogonal to unit vector n, normalized.
+template<typename U>
+void orthogonalize3(const U* v, const U* n, U* r)
+{
+    const U d = dot3(v, n);
+    r[0] = v[0] - d * n[0];
+    r[1] = v[1] - d * n[1];
+    r[2] = v[2] - d * n[2];
+    normalize3(r);
+}
+
+} // detail
+
+// Solid angle subtended by spherical triangle with unit vertices a, b, c.
+// See: A. Van Oosterom, J. Strackee, "The Solid Angle of a Plane Triangle".
+template<typename U>
+U spherical_triangle_solid_angle(const U* a, const U* b, const U* c)
+{
+    U bc[3];
+    detail::cross3(b, c, bc);
+    const U numerator = std::abs(detail::dot3(a, bc));
+    const U denominator = U(1.0) + detail::dot3(a, b) + detail::dot3(b, c) + detail::dot3(c, a);
+    return U(2.0) * std::atan2(numerator, denominator);
+}
+
+// Uniform sampling of solid angle subtended by spherical triangle with unit vertices a, b, c
+// (i.e. directions towards triangle vertices from the shading point). Returns a unit direction.
+// See: J. Arvo, "Stratified Sampling of Spherical Triangles".
+template<typename U>
+void spherical_triangle(const U* a, const U* b, const U* c, U u1, U u2, U& px, U& py, U& pz)
+{
+    // Internal angles from normals of the great circles through each edge.
+    U n_ab[3], n_bc[3], n_ca[3];
+    detail::cross3(a, b, n_ab);
+    detail::cross3(b, c, n_bc);
+    detail::cross3(c, a, n_ca);
+    detail::normalize3(n_ab);
+    detail::normalize3(n_bc);
+    detail::normalize3(n_ca);
+    const U alpha = std::acos(detail::clamp_unit(-detail::dot3(n_ab, n_ca)));
+    const U beta  = std::acos(detail::clamp_unit(-detail::dot3(n_bc, n_ab)));
+    const U gamma = std::acos(detail::clamp_unit(-detail::dot3(n_ca, n_bc)));
+    const U area = alpha + beta + gamma - detail::pi<U>();
+
+    // Select sub-triangle with area proportional to u1 by finding its vertex c_hat on edge ac.
+    const U area_hat = u1 * area;
+    const U s = std::sin(area_hat - alpha);
+    const U t = std::cos(area_hat - alpha);
+    const U cos_alpha = std::cos(alpha);
+    const U sin_alpha = std::sin(alpha);
+    const U u = t - cos_alpha;
+    const U v = s + sin_alpha * detail::dot3(a, b);
+    const U denominator = (v * s + u * t) * sin_alpha;
+    const U q = (denominator != U(0.0)) ? detail::clamp_unit(((v * t - u * s) * cos_alpha - v) / denominator) : U(1.0);
+
+    U c_perp[3];
+    detail::orthogonalize3(c, a, c_perp);
+    const U q_perp = std::sqrt(std::max(U(0.0), U(1.0) - q * q));
+    U c_hat[3] = {
+        q * a[0] + q_perp * c_perp[0],
+        q * a[1] + q_perp * c_perp[1],
+        q * a[2] + q_perp * c_perp[2],
+    };
+
+    // Sample arc between b and c_hat uniformly in cosine.
+    const U z = U(1.0) - u2 * (U(1.0) - detail::dot3(c_hat, b));
+    const U z_perp = std::sqrt(std::max(U(0.0), U(1.0) - z * z));
+    U c_hat_perp[3];
+    detail::orthogonalize3(c_hat, b, c_hat_perp);
+    px = z * b[0] + z_perp * c_hat_perp[0];
+    py = z * b[1] + z_perp * c_hat_perp[1];
+    pz = z * b[2] + z_perp * c_hat_perp[2];
+}
+
+template<typename U>
+U spherical_triangle_pdf(const U* a, const U* b, const U* c)
+{
+    return U(1.0) / spherical_triangle_solid_angle(a, b, c);
+}
+
+template<typename T, typename U=typename detail::component<T>::type>
+T spherical_triangle(const T& a, const T& b, const T& c, U u1, U u2)
+{
+    const U pa[] = { a[0], a[1], a[2] };
+    const U pb[] = { b[0], b[1], b[2] };
+    const U pc[] = { c[0], c[1], c[2] };
+    T r;
+    spherical_triangle(pa, pb, pc, u1, u2, r[0], r[1], r[2]);
+    return r;
+}
+
+template<typename T, typename V, typename U=typename detail::component<T>::type>
+T spherical_triangle(const T& a, const T& b, const T& c, const V& u)
+{
+    return spherical_triangle(a, b, c, U(u[0]), U(u[1]));
+}
+
+template<typename T, typename U=typename detail::component<T>::type>
+U spherical_triangle_pdf(const T& a, const T& b, const T& c)
+{
+    const U pa[] = { a[0], a[1], a[2] };
+    const U pb[] = { b[0], b[1], b[2] };
+    const U pc[] = { c[0], c[1], c[2] };
+    return spherical_triangle_pdf(pa, pb, pc);
+}
+
+template<typename U>
+void spherical_triangle(const U* a, const U* b, const U* c, const U* u, U* p)
+{
+    spherical_triangle(a, b, c, u[0], u[1], p[0], p[1], p[2]);
+}
+
+template<typename U>
+void spherical_triangle(const U* a, const U* b, const U* c, const U* u, U* p, size_t count)
+{
+    detail::warp_batch<2, 3>(u, p, count, [a, b, c](const U* ui, U* pi) { spherical_triangle(a, b, c, ui, pi); });
+}
+
+template<typename U, typename V>
+void spherical_triangle(const U* a, const U* b, const U* c, const soa_buffer<V, 2>& u, const soa_buffer<U, 3>& p, size_t count)
+{
+    detail::warp_batch<2, 3>(u, p, count, [a, b, c](const U* ui, U* pi) { spherical_triangle(a, b, c, ui, pi); });
+}
+
+// Spherical rectangle: solid angle subtended by planar rectangle (corner s, orthogonal edges ex & ey) as seen from point o.
+// Setup is shared by all samples of the rectangle.
+// See: C. Ureña, M. Fajardo, A. King, "An Area-Preserving Parametrization for Spherical Rectangles".
+template<typename U>
+struct spherical_rectangle_t
+{
+    spherical_rectangle_t(const U* o, const U* s, const U* ex, const U* ey)
+    {
+        const U ex_length = detail::length3(ex);
+        const U ey_length = detail::length3(ey);
+        for(unsigned int i=0; i<3; ++i) {
+            origin[i] = o[i];
+            x[i] = ex[i] / ex_length;
+            y[i] = ey[i] / ey_length;
+        }
+        detail::cross3(x, y, z);
+
+        const U d[] = { s[0] - o[0], s[1] - o[1], s[2] - o[2] };
+        z0 = detail::dot3(d, z);
+        // Flip z to make it point against the rectangle.
+        if(z0 > U(0.0)) {
+            z[0] = -z[0]; z[1] = -z[1]; z[2] = -z[2];
+            z0 = -z0;
+        }
+        z0_sqr = z0 * z0;
+        x0 = detail::dot3(d, x);
+        y0 = detail::dot3(d, y);
+        x1 = x0 + ex_length;
+        y1 = y0 + ey_length;
+        y0_sqr = y0 * y0;
+        y1_sqr = y1 * y1;
+
+        // Normals of the planes through origin and rectangle edges (in local frame).
+        const U n0[] = { U(0.0), z0, -y0 };
+        const U n1[] = { -z0, U(0.0), x1 };
+        const U n2[] = { U(0.0), -z0, y1 };
+        const U n3[] = { z0, U(0.0), -x0 };
+        const U inv_n0 = U(1.0) / std::sqrt(z0_sqr + y0_sqr);
+        const U inv_n1 = U(1.0) / std::sqrt(z0_sqr + x1 * x1);
+        const U inv_n2 = U(1.0) / std::sqrt(z0_sqr + y1_sqr);
+        const U inv_n3 = U(1.0) / std::sqrt(z0_sqr + x0 * x0);
+
+        // Internal angles and solid angle.
+        const U g0 = std::acos(detail::clamp_unit(-detail::dot3(n0, n1) * inv_n0 * inv_n1));
+        const U g1 = std::acos(detail::clamp_unit(-detail::dot3(n1, n2) * inv_n1 * inv_n2));
+        const U g2 = std::acos(detail::clamp_unit(-detail::dot3(n2, n3) * inv_n2 * inv_n3));
+        const U g3 = std::acos(detail::clamp_unit(-detail::dot3(n3, n0) * inv_n3 * inv_n0));
+        b0 = n0[2] * inv_n0;
+        b1 = n2[2] * inv_n2;
+        b0_sqr = b0 * b0;
+        k = U(2.0) * detail::pi<U>() - g2 - g3;
+        solid_angle = g0 + g1 - k;
+    }
+
+    U origin[3];
+    U x[3], y[3], z[3];
+    U x0, y0, z0, x1, y1;
+    U y0_sqr, y1_sqr, z0_sqr;
+    U b0, b1, b0_sqr, k;
+    U solid_angle;
+};
+
+// Returns point on the rectangle; direction of the sample is (p - o) normalized.
+template<typename U>
+void spherical_rectangle(const spherical_rectangle_t<U>& rect, U u1, U u2, U& px, U& py, U& pz)
+{
+    // Compute cu and xu from u1.
+    const U au = u1 * rect.solid_angle + rect.k;
+    const U fu = (std::cos(au) * rect.b0 - rect.b1) / std::sin(au);
+    U cu = U(1.0) / std::sqrt(fu * fu + rect.b0_sqr) * ((fu > U(0.0)) ? U(1.0) : U(-1.0));
+    cu = detail::clamp_unit(cu);
+    U xu = -(cu * rect.z0) / std::sqrt(std::max(U(1.0) - cu * cu, std::numeric_limits<U>::min()));
+    xu = std::max(rect.x0, std::min(rect.x1, xu));
+
+    // Compute yv from u2.
+    const U d = std::sqrt(xu * xu + rect.z0_sqr);
+    const U h0 = rect.y0 / std::sqrt(d * d + rect.y0_sqr);
+    const U h1 = rect.y1 / std::sqrt(d * d + rect.y1_sqr);
+    const U hv = h0 + u2 * (h1 - h0);
+    const U hv_sqr = hv * hv;
+    const U yv = (hv_sqr < U(1.0) - std::numeric_limits<U>::epsilon()) ? (hv * d) / std::sqrt(U(1.0) - hv_sqr) : rect.y1;
+
+    px = rect.origin[0] + xu * rect.x[0] + yv * rect.y[0] + rect.z0 * rect.z[0];
+    py = rect.origin[1] + xu * rect.x[1] + yv * rect.y[1] + rect.z0 * rect.z[1];
+    pz = rect.origin[2] + xu * rect.x[2] + yv * rect.y[2] + rect.z0 * rect.z[2];
+}
+
+template<typename U>
+U spherical_rectangle_pdf(const spherical_rectangle_t<U>& rect)
+{
+    return U(1.0) / rect.solid_angle;
+}
+
+template<typename T, typename U=typename detail::component<T>::type>
+T spherical_rectangle(const spherical_rectangle_t<U>& rect, U u1, U u2)
+{
+    T r;
+    spherical_rectangle(rect, u1, u2, r[0], r[1], r[2]);
+    return r;
+}
+
+template<typename T, typename V, typename U=typename detail::component<T>::type>
+T spherical_rectangle(const spherical_rectangle_t<U>& rect, const V& u)
+{
+    T r;
+    spherical_rectangle(rect, U(u[0]), U(u[1]), r[0], r[1], r[2]);
+    return r;
+}
+
+template<typename U>
+void spherical_rectangle(const spherical_rectangle_t<U>& rect, const U* u, U* p)
+{
+    spherical_rectangle(rect, u[0], u[1], p[0], p[1], p[2]);
+}
+
+template<typename U>
+void spherical_rectangle(const spherical_rectangle_t<U>& rect, const U* u, U* p, size_t count)
+{
+    detail::warp_batch<2, 3>(u, p, count, [&rect](const U* ui, U* pi) { spherical_rectangle(rect, ui, pi); });
+}
+
+template<typename U, typename V>
+void spherical_rectangle(const spherical_rectangle_t<U>& rect, const soa_buffer<V, 2>& u, const soa_buffer<U, 3>& p, size_t count)
+{
+    detail::warp_batch<2, 3>(u, p, count, [&rect](const U* ui, U* pi) { spherical_rectangle(rect, ui, pi); });
+}
+
+} // rsm
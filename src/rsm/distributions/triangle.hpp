@@ -0,0 +1,98 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cmath>
+
+#include "../detail/common.hpp"
+#include "../detail/vector.hpp"
+#include "../detail/batch.hpp"
+
+namespace rsm {
+
+// Barycentric coordinates of a uniformly distributed point using low-distortion square to triangle mapping.
+// See: E. Heitz, "A Low-Distortion Map Between Triangle and Square".
+template<typename U>
+void triangle_barycentric(U u1, U u2, U& b0, U& b1, U& b2)
+{
+    if(u1 < u2) {
+        b0 = U(0.5) * u1;
+        b1 = u2 - b0;
+    }
+    else {
+        b1 = U(0.5) * u2;
+        b0 = u1 - b1;
+    }
+    b2 = U(1.0) - b0 - b1;
+}
+
+template<typename U>
+void triangle(const U* a, const U* b, const U* c, U u1, U u2, U& px, U& py, U& pz)
+{
+    U b0, b1, b2;
+    triangle_barycentric(u1, u2, b0, b1, b2);
+    px = b0 * a[0] + b1 * b[0] + b2 * c[0];
+    py = b0 * a[1] + b1 * b[1] + b2 * c[1];
+    pz = b0 * a[2] + b1 * b[2] + b2 * c[2];
+}
+
+template<typename U>
+U triangle_pdf(const U* a, const U* b, const U* c)
+{
+    const U e1[] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+    const U e2[] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+    U n[3];
+    detail::cross3(e1, e2, n);
+    return U(2.0) / detail::length3(n);
+}
+
+template<typename T, typename U=typename detail::component<T>::type>
+T triangle(const T& a, const T& b, const T& c, U u1, U u2)
+{
+    const U pa[] = { a[0], a[1], a[2] };
+    const U pb[] = { b[0], b[1], b[2] };
+    const U pc[] = { c[0], c[1], c[2] };
+    T r;
+    triangle(pa, pb, pc, u1, u2, r[0], r[1], r[2]);
+    return r;
+}
+
+template<typename T, typename V, typename U=typename detail::component<T>::type>
+T triangle(const T& a, const T& b, const T& c, const V& u)
+{
+    return triangle(a, b, c, U(u[0]), U(u[1]));
+}
+
+template<typename T, typename U=typename detail::component<T>::type>
+U triangle_pdf(const T& a, const T& b, const T& c)
+{
+    const U pa[] = { a[0], a[1], a[2] };
+    const U pb[] = { b[0], b[1], b[2] };
+    const U pc[] = { c[0], c[1], c[2] };
+    return triangle_pdf(pa, pb, pc);
+}
+
+template<typename U>
+void triangle(const U* a, const U* b, const U* c, const U* u, U* p)
+{
+    triangle(a, b, c, u[0], u[1], p[0], p[1], p[2]);
+}
+
+template<typename U>
+void triangle(const U* a, const U* b, const U* c, const U* u, U* p, size_t count)
+{
+    detail::warp_batch<2, 3>(u, p, count, [a, b, c](const U* ui, U* pi) { triangle(a, b, c, ui, pi); });
+}
+
+template<typename U, typename V>
+void triangle(const U* a, const U* b, const U* c, const soa_buffer<V, 2>& u, const soa_buffer<U, 3>& p, size_t count)
+{
+    detail::warp_batch<2, 3>(u, p, count, [a, b, c](const U* ui, U* pi) { triangle(a, b, c, ui, pi); });
+}
+
+} // rsm
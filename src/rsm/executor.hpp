@@ -0,0 +1,75 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace rsm {
+
+// Executors run a number of independent tasks: parallel_for(num_tasks, f) calls f(task_index) exactly once
+// for every task index in [0..num_tasks). Any type with a compatible parallel_for() (e.g. a thin wrapper
+// over an external thread pool) can be used wherever an executor is expected.
+
+struct sequential_executor
+{
+    template<typename F>
+    void parallel_for(size_t num_tasks, F&& f) const
+    {
+        for(size_t i=0; i<num_tasks; ++i) {
+            f(i);
+        }
+    }
+};
+
+class thread_executor
+{
+public:
+    explicit thread_executor(unsigned int num_threads=0)
+        : m_num_threads(num_threads > 0 ? num_threads : std::max(1u, std::thread::hardware_concurrency()))
+    {}
+
+    template<typename F>
+    void parallel_for(size_t num_tasks, F&& f) const
+    {
+        const size_t num_workers = std::min<size_t>(m_num_threads, num_tasks);
+        if(num_workers <= 1) {
+            sequential_executor{}.parallel_for(num_tasks, f);
+            return;
+        }
+
+        std::atomic<size_t> next_task{0};
+        auto worker = [&]() {
+            for(size_t i; (i = next_task.fetch_add(1, std::memory_order_relaxed)) < num_tasks;) {
+                f(i);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(num_workers - 1);
+        for(size_t i=1; i<num_workers; ++i) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for(auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    unsigned int num_threads() const
+    {
+        return m_num_threads;
+    }
+
+private:
+    unsigned int m_num_threads;
+};
+
+} // rsm
@@ -0,0 +1,116 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../detail/common.hpp"
+#include "../next.hpp"
+
+namespace rsm {
+namespace detail {
+
+// Uses generate(buffer, count) member if generator provides one.
+template<typename Generator>
+inline auto generate_block(Generator& generator, typename Generator::result_type* buffer, size_t count, int)
+    -> decltype(generator.generate(buffer, count))
+{
+    generator.generate(buffer, count);
+}
+
+// Runs on a local copy of generator state which lets the compiler keep it in registers for the whole loop.
+template<typename Generator>
+inline void generate_block(Generator& generator, typename Generator::result_type* buffer, size_t count, long)
+{
+    Generator local_generator = generator;
+    for(size_t i=0; i<count; ++i) {
+        buffer[i] = local_generator();
+    }
+    generator = local_generator;
+}
+
+} // detail
+
+// Wraps a generator and serves its output from a block refilled BlockSize values at a time.
+// Produces exactly the same sequence as the wrapped generator, also through next<float> and next<double> which use
+// detail::variate_conversion of the wrapped generator, so it can be used in place of it anywhere a generator is expected.
+// Block is cache line aligned (when allocated on the stack or with an aligned allocator). Pays off if refilling a block
+// is cheaper than making BlockSize separate calls, e.g. with a vectorized generate() member such as pcg32::generate().
+template<typename Generator, size_t BlockSize=64>
+class buffered_generator
+{
+public:
+    static_assert(BlockSize > 0, "BlockSize must not be zero");
+
+    using result_type = typename Generator::result_type;
+    using generator_type = Generator;
+
+    buffered_generator()
+        : m_index(BlockSize)
+    {}
+
+    explicit buffered_generator(uint64_t s)
+        : m_generator(s)
+        , m_index(BlockSize)
+    {}
+
+    explicit buffered_generator(const Generator& generator)
+        : m_generator(generator)
+        , m_index(BlockSize)
+    {}
+
+    void seed(uint64_t s)
+    {
+        m_generator.seed(s);
+        m_index = BlockSize;
+    }
+
+    result_type operator()()
+    {
+        if(m_index == BlockSize) {
+            refill();
+        }
+        return m_block[m_index++];
+    }
+
+    static constexpr result_type min()
+    {
+        return Generator::min();
+    }
+
+    static constexpr result_type max()
+    {
+        return Generator::max();
+    }
+
+    // Wrapped generator; its state is ahead of the buffered output by the number of values still in the block.
+    const Generator& generator() const
+    {
+        return m_generator;
+    }
+
+private:
+    void refill()
+    {
+        detail::generate_block(m_generator, m_block, BlockSize, 0);
+        m_index = 0;
+    }
+
+    alignas(64) result_type m_block[BlockSize];
+    Generator m_generator;
+    size_t m_index;
+};
+
+namespace detail {
+
+// Variates are converted with the wrapped generator's conversion so they match those drawn from it directly.
+template<typename Generator, size_t BlockSize>
+struct variate_conversion<buffered_generator<Generator, BlockSize>> : variate_conversion<Generator> {};
+
+} // detail
+} // rsm
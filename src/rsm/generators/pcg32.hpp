@@ -28,11 +28,13 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 
 #include "../detail/common.hpp"
 #include "../next.hpp"
+#include "../stats.hpp"
 
 #include "splitmix64.hpp"
 
@@ -77,11 +79,38 @@ public:
 
     result_type operator()()
     {
+        RSM_STATS_ADD(generator_calls, 1);
         uint64_t oldstate = m_state;
-        m_state = oldstate * 6364136223846793005ull + m_inc;
-        uint32_t xorshifted = ((oldstate >> 18u) ^ oldstate) >> 27u;
-        uint32_t rot = oldstate >> 59u;
-        return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+        m_state = oldstate * multiplier + m_inc;
+        return output(oldstate);
+    }
+
+    // Fills buffer with the next count outputs. Four interleaved streams, each advanced four steps at a time,
+    // break the serial dependency on the state update so that consecutive outputs can be computed in parallel.
+    void generate(result_type* buffer, size_t count)
+    {
+        RSM_STATS_ADD(generator_calls, count);
+        constexpr uint64_t multiplier2 = multiplier * multiplier;
+        constexpr uint64_t multiplier4 = multiplier2 * multiplier2;
+        const uint64_t inc4 = m_inc * (1 + multiplier) * (1 + multiplier2);
+
+        uint64_t state[4];
+        state[0] = m_state;
+        for(unsigned int k=1; k<4; ++k) {
+            state[k] = state[k-1] * multiplier + m_inc;
+        }
+        const size_t num_blocks = count / 4;
+        for(size_t i=0; i<num_blocks; ++i) {
+            for(unsigned int k=0; k<4; ++k) {
+                buffer[4*i+k] = output(state[k]);
+                state[k] = state[k] * multiplier4 + inc4;
+            }
+        }
+        m_state = state[0];
+        for(size_t i=4*num_blocks; i<count; ++i) {
+            buffer[i] = output(m_state);
+            m_state = m_state * multiplier + m_inc;
+        }
     }
 
     static constexpr result_type min()
@@ -95,6 +124,15 @@ public:
     }
 
 private:
+    static constexpr uint64_t multiplier = 6364136223846793005ull;
+
+    static uint32_t output(uint64_t state)
+    {
+        uint32_t xorshifted = ((state >> 18u) ^ state) >> 27u;
+        uint32_t rot = state >> 59u;
+        return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+    }
+
     uint64_t m_state;
     uint64_t m_inc;
 };
@@ -102,16 +140,18 @@ private:
 namespace detail {
 
 template<>
-inline float next(next_value_t<float>, pcg32& generator)
+struct variate_conversion<pcg32>
 {
-    return u32_as_float(generator());
-}
+    static float to_float(pcg32::result_type value)
+    {
+        return u32_as_float(value);
+    }
 
-template<>
-inline double next(next_value_t<double>, pcg32& generator)
-{
-    return static_cast<double>(u32_as_float(generator()));
-}
+    static double to_double(pcg32::result_type value)
+    {
+        return static_cast<double>(u32_as_float(value));
+    }
+};
 
 } // detail
 } // rsm
@@ -30,6 +30,7 @@
 
 #include "../detail/common.hpp"
 #include "../next.hpp"
+#include "../stats.hpp"
 
 namespace rsm {
 
@@ -53,6 +54,7 @@ public:
 
     result_type operator()()
     {
+        RSM_STATS_ADD(generator_calls, 1);
         uint64_t z = (m_state += 0x9e3779b97f4a7c15ull);
         z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
         z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
@@ -78,16 +80,18 @@ using default_generator = splitmix64;
 namespace detail {
 
 template<>
-inline float next(next_value_t<float>, splitmix64& generator)
+struct variate_conversion<splitmix64>
 {
-    return u32_as_float(static_cast<uint32_t>(generator()));
-}
+    static float to_float(splitmix64::result_type value)
+    {
+        return u32_as_float(static_cast<uint32_t>(value));
+    }
 
-template<>
-inline double next(next_value_t<double>, splitmix64& generator)
-{
-    return u64_as_double(generator());
-}
+    static double to_double(splitmix64::result_type value)
+    {
+        return u64_as_double(value);
+    }
+};
 
 } // detail
 } // rsm
@@ -16,28 +16,32 @@ namespace rsm {
 namespace detail {
 
 template<>
-inline float next(next_value_t<float>, std::mt19937& generator)
+struct variate_conversion<std::mt19937>
 {
-    return u32_as_float(generator());
-}
+    static float to_float(std::mt19937::result_type value)
+    {
+        return u32_as_float(static_cast<uint32_t>(value));
+    }
 
-template<>
-inline double next(next_value_t<double>, std::mt19937& generator)
-{
-    return static_cast<double>(u32_as_float(generator()));
-}
-
-template<>
-inline float next(next_value_t<float>, std::mt19937_64& generator)
-{
-    return u32_as_float(static_cast<uint32_t>(generator()));
-}
+    static double to_double(std::mt19937::result_type value)
+    {
+        return static_cast<double>(u32_as_float(static_cast<uint32_t>(value)));
+    }
+};
 
 template<>
-inline double next(next_value_t<double>, std::mt19937_64& generator)
+struct variate_conversion<std::mt19937_64>
 {
-    return u64_as_double(generator());
-}
+    static float to_float(std::mt19937_64::result_type value)
+    {
+        return u32_as_float(static_cast<uint32_t>(value));
+    }
+
+    static double to_double(std::mt19937_64::result_type value)
+    {
+        return u64_as_double(value);
+    }
+};
 
 } // detail
 } // rsm
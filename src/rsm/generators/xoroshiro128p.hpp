@@ -34,6 +34,7 @@
 
 #include "../detail/common.hpp"
 #include "../next.hpp"
+#include "../stats.hpp"
 
 #include "splitmix64.hpp"
 
@@ -62,6 +63,7 @@ public:
 
     result_type operator()()
     {
+        RSM_STATS_ADD(generator_calls, 1);
         uint64_t s0 = m_state[0];
         uint64_t s1 = m_state[1];
         uint64_t result = s0 + s1;
@@ -94,16 +96,18 @@ private:
 namespace detail {
 
 template<>
-inline float next(next_value_t<float>, xoroshiro128p& generator)
+struct variate_conversion<xoroshiro128p>
 {
-    return u32_as_float(static_cast<uint32_t>(generator()));
-}
+    static float to_float(xoroshiro128p::result_type value)
+    {
+        return u32_as_float(static_cast<uint32_t>(value));
+    }
 
-template<>
-inline double next(next_value_t<double>, xoroshiro128p& generator)
-{
-    return u64_as_double(generator());
-}
+    static double to_double(xoroshiro128p::result_type value)
+    {
+        return u64_as_double(value);
+    }
+};
 
 } // detail
 } // rsm
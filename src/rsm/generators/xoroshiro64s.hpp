@@ -28,6 +28,7 @@
 
 #include "../detail/common.hpp"
 #include "../next.hpp"
+#include "../stats.hpp"
 
 #include "splitmix64.hpp"
 
@@ -56,6 +57,7 @@ public:
 
     result_type operator()()
     {
+        RSM_STATS_ADD(generator_calls, 1);
         uint32_t s0 = m_state[0];
         uint32_t s1 = m_state[1];
         uint32_t result_star = s0 * 0x9e3779bbul;
@@ -88,16 +90,18 @@ private:
 namespace detail {
 
 template<>
-inline float next(next_value_t<float>, xoroshiro64s& generator)
+struct variate_conversion<xoroshiro64s>
 {
-    return u32_as_float(generator());
-}
+    static float to_float(xoroshiro64s::result_type value)
+    {
+        return u32_as_float(value);
+    }
 
-template<>
-inline double next(next_value_t<double>, xoroshiro64s& generator)
-{
-    return static_cast<double>(u32_as_float(generator()));
-}
+    static double to_double(xoroshiro64s::result_type value)
+    {
+        return static_cast<double>(u32_as_float(value));
+    }
+};
 
 } // detail
 } // rsm
@@ -14,10 +14,6 @@
 
 #include "generators/pcg32.hpp"
 
-#ifndef RSM_MAX_LDS_DIMENSIONS
-#define RSM_MAX_LDS_DIMENSIONS 128
-#endif
-
 static_assert(RSM_MAX_LDS_DIMENSIONS >= 2, "RSM_MAX_LDS_DIMENSIONS must be at least 2");
 
 namespace rsm {
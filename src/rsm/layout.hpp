@@ -0,0 +1,47 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <array>
+
+namespace rsm {
+
+// Structure-of-arrays output: dimension dim of i-th sample is written to data[dim][i].
+template<typename T, unsigned int N>
+struct soa_buffer
+{
+    std::array<T*, N> data;
+};
+
+// Arbitrary strided output: dimension dim of i-th sample is written to data[i * sample_stride + dim * dim_stride].
+template<typename T>
+struct strided_buffer
+{
+    T* data;
+    size_t sample_stride;
+    size_t dim_stride;
+};
+
+// SoA view of a single allocation holding N arrays of pitch elements each.
+template<unsigned int N, typename T>
+soa_buffer<T, N> soa(T* data, size_t pitch)
+{
+    soa_buffer<T, N> buffer;
+    for(unsigned int dim=0; dim<N; ++dim) {
+        buffer.data[dim] = data + dim * pitch;
+    }
+    return buffer;
+}
+
+template<typename T>
+strided_buffer<T> strided(T* data, size_t sample_stride, size_t dim_stride=1)
+{
+    return strided_buffer<T>{data, sample_stride, dim_stride};
+}
+
+} // rsm
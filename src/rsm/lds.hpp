@@ -7,60 +7,250 @@
 #pragma once
 
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <type_traits>
+#include <utility>
 
+#include "detail/common.hpp"
 #include "detail/primes.hpp"
 #include "detail/ldsperm.hpp"
 
 namespace rsm {
 
-template<typename T>
-T radical_inverse(uint16_t base, uint64_t value)
+namespace detail {
+
+// Base is either a runtime integer or std::integral_constant in which case divisions can be strength-reduced.
+template<typename T, bool Scrambled, typename Base>
+T radical_inverse_impl(Base base, const uint16_t* perm, uint64_t value, std::false_type)
 {
-    assert(base >= 2);
     const T inv_base = T(1) / base;
     T inv_base_n = T(1);
     uint64_t inverse = 0;
     for(uint64_t n; value > 0; value = n) {
         n = value / base;
         uint16_t d = static_cast<uint16_t>(value - n * base);
-        inverse = inverse * base + d;
+        inverse = inverse * base + (Scrambled ? perm[d] : d);
         inv_base_n *= inv_base;
     }
     return inverse * inv_base_n;
 }
 
-template<typename T>
-T radical_inverse_scrambled(uint16_t base, const uint16_t* perm, uint64_t value)
+// Fixed-point radical inverse: returns floor(2^32 * phi(value)) computed exactly in integer arithmetic.
+template<typename T, bool Scrambled, typename Base>
+T radical_inverse_impl(Base base, const uint16_t* perm, uint64_t value, std::true_type)
 {
-    assert(base >= 2);
-    const T inv_base = T(1) / base;
-    T inv_base_n = T(1);
-    uint64_t inverse = 0;
+    static_assert(std::is_same<T, uint32_t>::value, "Fixed-point radical inverse is only supported for uint32_t");
+
+    uint16_t digits[64];
+    unsigned int num_digits = 0;
     for(uint64_t n; value > 0; value = n) {
         n = value / base;
-        uint16_t d = static_cast<uint16_t>(value - n * base);
-        inverse = inverse * base + perm[d];
-        inv_base_n *= inv_base;
+        digits[num_digits++] = static_cast<uint16_t>(value - n * base);
     }
-    return inverse * inv_base_n;
+    // Evaluate from the most significant digit; floor((d + floor(x)) / b) == floor((d + x) / b) keeps this exact.
+    uint64_t inverse = 0;
+    while(num_digits > 0) {
+        uint16_t d = digits[--num_digits];
+        inverse = ((uint64_t(Scrambled ? perm[d] : d) << 32) + inverse) / base;
+    }
+    return static_cast<uint32_t>(inverse);
+}
+
+template<typename T, bool Scrambled>
+T radical_inverse_impl(std::integral_constant<uint32_t, 2>, const uint16_t*, uint64_t value, std::true_type)
+{
+    static_assert(!Scrambled, "Base 2 is never scrambled");
+    return reverse_bits(static_cast<uint32_t>(value));
+}
+
+} // detail
+
+template<typename T>
+T radical_inverse(uint16_t base, uint64_t value)
+{
+    assert(base >= 2);
+    return detail::radical_inverse_impl<T, false>(uint32_t(base), nullptr, value, std::is_integral<T>{});
+}
+
+template<typename T>
+T radical_inverse_scrambled(uint16_t base, const uint16_t* perm, uint64_t value)
+{
+    assert(base >= 2);
+    return detail::radical_inverse_impl<T, true>(uint32_t(base), perm, value, std::is_integral<T>{});
+}
+
+namespace detail {
+
+// Halton & Hammersley sequences for bases 2 and 3 exhibit reasonably good distribution and don't need to be scrambled.
+template<typename T, unsigned int Dim>
+T radical_inverse_dim(const uint16_t* perm, uint64_t value)
+{
+    static_assert(Dim < RSM_MAX_LDS_DIMENSIONS, "Dimension exceeds RSM_MAX_LDS_DIMENSIONS");
+    using base = std::integral_constant<uint32_t, g_static_primes.p[Dim]>;
+    return radical_inverse_impl<T, (Dim >= 2)>(base{}, perm, value, std::is_integral<T>{});
 }
 
+template<typename T, size_t... Dim>
+T radical_inverse_dispatch(unsigned int dim, const uint16_t* perm, uint64_t value, std::index_sequence<Dim...>)
+{
+    using fn_type = T(*)(const uint16_t*, uint64_t);
+    static constexpr fn_type table[] = { &radical_inverse_dim<T, Dim>... };
+    return table[dim](perm, value);
+}
+
+// Evaluates N consecutive low discrepancy dimensions starting at BaseDim for a run of consecutive offsets.
+// Every base is a compile-time constant and the per-dimension loop is fully unrolled,
+// so a whole point is computed without any runtime dispatch.
+template<typename Scalar, unsigned int N, typename Output, unsigned int OutputDim=0>
+struct radical_inverse_kernel
+{
+    template<typename Buffer>
+    using fn_type = void(*)(const uint16_t* const*, uint64_t, size_t, Buffer);
+
+    static constexpr unsigned int num_base_dims = (N <= RSM_MAX_LDS_DIMENSIONS) ? (RSM_MAX_LDS_DIMENSIONS - N + 1) : 1;
+
+    template<unsigned int BaseDim, typename Buffer, size_t... I>
+    static void evaluate(const uint16_t* const* perm, uint64_t offset, size_t count, Buffer buffer, std::index_sequence<I...>)
+    {
+        for(size_t i=0; i<count; ++i, ++offset) {
+            int unpack[] = { (Output::store(buffer, i, OutputDim + I, variate<Scalar>(radical_inverse_dim<Scalar, BaseDim + I>(perm[I], offset))), 0)... };
+            (void)unpack;
+        }
+    }
+
+    template<unsigned int BaseDim, typename Buffer>
+    static void evaluate_at(const uint16_t* const* perm, uint64_t offset, size_t count, Buffer buffer)
+    {
+        evaluate<BaseDim>(perm, offset, count, buffer, std::make_index_sequence<N>{});
+    }
+
+    template<typename Buffer, size_t... BaseDim>
+    static fn_type<Buffer> lookup(unsigned int base_dim, std::index_sequence<BaseDim...>)
+    {
+        static constexpr fn_type<Buffer> table[] = { &evaluate_at<BaseDim, Buffer>... };
+        return table[base_dim];
+    }
+
+    template<typename Buffer>
+    static fn_type<Buffer> lookup(unsigned int base_dim, std::true_type)
+    {
+        if(base_dim >= num_base_dims) {
+            return nullptr;
+        }
+        return lookup<Buffer>(base_dim, std::make_index_sequence<num_base_dims>{});
+    }
+
+    template<typename Buffer>
+    static fn_type<Buffer> lookup(unsigned int, std::false_type)
+    {
+        return nullptr;
+    }
+
+    // Returns nullptr if requested dimensions lie outside of compile-time range (see RSM_MAX_LDS_DIMENSIONS).
+    template<typename Buffer>
+    static fn_type<Buffer> lookup(unsigned int base_dim)
+    {
+#ifndef RSM_NO_STATIC_DISPATCH
+        return lookup<Buffer>(base_dim, std::integral_constant<bool, (N <= RSM_MAX_LDS_DIMENSIONS)>{});
+#else
+        (void)base_dim;
+        return nullptr;
+#endif
+    }
+};
+
+// Buffer fills of at least this many samples use radical_inverse_odometer instead of evaluating every offset from scratch.
+constexpr size_t lds_sequential_min_count = 16;
+constexpr size_t lds_sequential_block_size = 256;
+
+// Evaluates (scrambled) radical inverse of consecutive integers by keeping the digits of the current value
+// and propagating carries on increment, which takes amortized constant time.
+// Produces results bit-identical to radical_inverse_scrambled() for floating-point T.
+template<typename T>
+class radical_inverse_odometer
+{
+    static_assert(std::is_floating_point<T>::value, "Radical inverse odometer requires floating-point type");
+public:
+    radical_inverse_odometer() = default;
+
+    radical_inverse_odometer(uint32_t base, const uint16_t* perm, uint64_t value)
+    {
+        reset(base, perm, value);
+    }
+
+    void reset(uint32_t base, const uint16_t* perm, uint64_t value)
+    {
+        assert(base >= 2);
+        m_perm = perm;
+        m_base = base;
+        m_num_digits = 0;
+        m_inverse = 0;
+        m_inv_base = T(1) / base;
+        m_inv_base_n = T(1);
+        for(uint64_t n; value > 0; value = n) {
+            n = value / base;
+            uint16_t d = static_cast<uint16_t>(value - n * base);
+            m_power[m_num_digits] = (m_num_digits > 0) ? m_power[m_num_digits-1] * base : 1;
+            m_digits[m_num_digits++] = d;
+            m_inverse = m_inverse * base + perm[d];
+            m_inv_base_n *= m_inv_base;
+        }
+    }
+
+    T value() const
+    {
+        return m_inverse * m_inv_base_n;
+    }
+
+    void increment()
+    {
+        // Digit weights are reversed: least significant digit of the value is the most significant digit of the inverse.
+        const uint16_t last = static_cast<uint16_t>(m_base - 1);
+        unsigned int k = 0;
+        while(k < m_num_digits && m_digits[k] == last) {
+            m_inverse -= m_perm[last] * m_power[m_num_digits-1 - k];
+            m_digits[k++] = 0;
+        }
+        if(k < m_num_digits) {
+            const uint16_t d = m_digits[k]++;
+            m_inverse += (uint64_t(m_perm[d+1]) - m_perm[d]) * m_power[m_num_digits-1 - k];
+        }
+        else {
+            // All digits wrapped around to zero (permutations always map 0 to 0): append new most significant digit.
+            assert(m_num_digits < 64);
+            m_power[m_num_digits] = (m_num_digits > 0) ? m_power[m_num_digits-1] * m_base : 1;
+            m_digits[m_num_digits++] = 1;
+            m_inverse = m_perm[1];
+            m_inv_base_n *= m_inv_base;
+        }
+    }
+
+private:
+    const uint16_t* m_perm;
+    uint32_t m_base;
+    unsigned int m_num_digits;
+    uint64_t m_inverse;
+    T m_inv_base;
+    T m_inv_base_n;
+    uint64_t m_power[64];
+    uint16_t m_digits[64];
+};
+
+} // detail
+
 template<typename T>
 T radical_inverse(unsigned int dim, uint16_t base, const uint16_t* perm, uint64_t value)
 {
-    // Halton & Hammersley sequences for bases 2 and 3 exhibit reasonably good distribution and don't need to be scrambled.
-    switch(dim) {
-    case 0:
-        return radical_inverse<T>(2, value);
-    case 1:
-        return radical_inverse<T>(3, value);
-#ifndef RSM_NO_RIJUMPTABLE
-#include "detail/rijumptable.inl"
+#ifndef RSM_NO_STATIC_DISPATCH
+    if(dim < RSM_MAX_LDS_DIMENSIONS) {
+        return detail::radical_inverse_dispatch<T>(dim, perm, value, std::make_index_sequence<RSM_MAX_LDS_DIMENSIONS>{});
+    }
 #endif
-    default:
-        return radical_inverse_scrambled<T>(base, perm, value);
+    if(dim < 2) {
+        return radical_inverse<T>(base, value);
     }
+    return radical_inverse_scrambled<T>(base, perm, value);
 }
 
 template<typename LowDiscrepancySampler>
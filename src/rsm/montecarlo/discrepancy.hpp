@@ -0,0 +1,206 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+#include "../executor.hpp"
+
+namespace rsm {
+
+// Quality metrics of point sets in [0..1)^N stored as count interleaved N-dimensional points.
+// Quadratic metrics are split into interleaved rows of the pair matrix executed in parallel by the executor;
+// partial sums are merged in fixed order so the result is identical regardless of the executor used.
+
+namespace detail {
+
+constexpr size_t discrepancy_max_tasks = 256;
+
+// Sum of f(i, j) over all pairs i <= j with off-diagonal pairs counted twice.
+template<unsigned int N, typename T, typename F, typename Executor>
+double sum_symmetric_pairs(const T* points, size_t count, const Executor& executor, F f)
+{
+    const size_t num_tasks = std::min(count, discrepancy_max_tasks);
+    std::vector<double> partial(num_tasks);
+    executor.parallel_for(num_tasks, [&](size_t task) {
+        double sum = 0.0;
+        for(size_t i=task; i<count; i += num_tasks) {
+            const T* x = points + N * i;
+            double row_sum = 0.0;
+            for(size_t j=i+1; j<count; ++j) {
+                row_sum += f(x, points + N * j);
+            }
+            sum += 2.0 * row_sum + f(x, x);
+        }
+        partial[task] = sum;
+    });
+    return std::accumulate(partial.begin(), partial.end(), 0.0);
+}
+
+// Warnock's formula, O(n^2 N).
+template<unsigned int N, typename T, typename Executor>
+double l2_star_discrepancy_sqr(const T* points, size_t count, const Executor& executor, std::false_type)
+{
+    double sum_single = 0.0;
+    for(size_t i=0; i<count; ++i) {
+        const T* x = points + N * i;
+        double product = 1.0;
+        for(unsigned int k=0; k<N; ++k) {
+            product *= 1.0 - double(x[k]) * double(x[k]);
+        }
+        sum_single += product;
+    }
+    const double sum_pairs = sum_symmetric_pairs<N>(points, count, executor, [](const T* x, const T* y) {
+        double product = 1.0;
+        for(unsigned int k=0; k<N; ++k) {
+            product *= 1.0 - double(std::max(x[k], y[k]));
+        }
+        return product;
+    });
+    const double n = double(count);
+    return std::pow(3.0, -double(N)) - std::pow(2.0, 1.0 - double(N)) / n * sum_single + sum_pairs / (n * n);
+}
+
+// Two dimensional case in O(n log n): with points sorted by x every pair term reduces to (1 - x_i) times
+// a sum over preceding points depending only on whether their y is below or above y_i, which is accumulated
+// in Fenwick trees of counts and sums of (1 - y) indexed by rank of y.
+template<unsigned int N, typename T, typename Executor>
+double l2_star_discrepancy_sqr(const T* points, size_t count, const Executor&, std::true_type)
+{
+    std::vector<uint32_t> by_x(count), by_y(count), y_rank(count);
+    std::iota(by_x.begin(), by_x.end(), 0u);
+    std::iota(by_y.begin(), by_y.end(), 0u);
+    std::sort(by_x.begin(), by_x.end(), [points](uint32_t a, uint32_t b) { return points[2*a] < points[2*b]; });
+    std::sort(by_y.begin(), by_y.end(), [points](uint32_t a, uint32_t b) { return points[2*a+1] < points[2*b+1]; });
+    for(size_t r=0; r<count; ++r) {
+        y_rank[by_y[r]] = static_cast<uint32_t>(r);
+    }
+
+    std::vector<double> tree_count(count + 1), tree_sum(count + 1);
+    double total_sum = 0.0;
+    double sum_single = 0.0;
+    double sum_pairs = 0.0;
+    for(size_t i=0; i<count; ++i) {
+        const uint32_t index = by_x[i];
+        const double x = points[2*index];
+        const double y = points[2*index+1];
+        sum_single += (1.0 - x * x) * (1.0 - y * y);
+
+        // Ties in y are ordered by rank and contribute equally from either side.
+        double below_count = 0.0;
+        double below_sum = 0.0;
+        for(size_t k=y_rank[index]; k>0; k &= k - 1) {
+            below_count += tree_count[k];
+            below_sum += tree_sum[k];
+        }
+        const double above_sum = total_sum - below_sum;
+        sum_pairs += 2.0 * (1.0 - x) * (below_count * (1.0 - y) + above_sum) + (1.0 - x) * (1.0 - y);
+
+        for(size_t k=y_rank[index]+1; k<=count; k += k & (~k + 1)) {
+            tree_count[k] += 1.0;
+            tree_sum[k] += 1.0 - y;
+        }
+        total_sum += 1.0 - y;
+    }
+    const double n = double(count);
+    return 1.0 / 9.0 - 0.5 / n * sum_single + sum_pairs / (n * n);
+}
+
+} // detail
+
+// L2-star discrepancy: L2 norm of the local discrepancy over boxes anchored at the origin.
+// Computed with Warnock's formula in O(n^2 N) time, or in O(n log n) time for N=2 (not parallelized).
+// See: T. T. Warnock, "Computational investigations of low-discrepancy point sets".
+template<unsigned int N, typename T, typename Executor=sequential_executor>
+double l2_star_discrepancy(const T* points, size_t count, const Executor& executor=Executor{})
+{
+    static_assert(N > 0, "Number of dimensions must be greater than zero");
+    assert(count > 0);
+    const double t2 = detail::l2_star_discrepancy_sqr<N>(points, count, executor, std::integral_constant<bool, N == 2>{});
+    return std::sqrt(std::max(t2, 0.0));
+}
+
+// Wrap-around (periodic) L2 discrepancy which, unlike the star discrepancy, is invariant to shifting
+// the point set modulo 1 (e.g. by Cranley-Patterson rotation).
+// See: F. J. Hickernell, "A generalized discrepancy and quadrature error bound".
+template<unsigned int N, typename T, typename Executor=sequential_executor>
+double wraparound_discrepancy(const T* points, size_t count, const Executor& executor=Executor{})
+{
+    static_assert(N > 0, "Number of dimensions must be greater than zero");
+    assert(count > 0);
+    const double sum_pairs = detail::sum_symmetric_pairs<N>(points, count, executor, [](const T* x, const T* y) {
+        double product = 1.0;
+        for(unsigned int k=0; k<N; ++k) {
+            const double d = std::abs(double(x[k]) - double(y[k]));
+            product *= 1.5 - d * (1.0 - d);
+        }
+        return product;
+    });
+    const double n = double(count);
+    const double t2 = sum_pairs / (n * n) - std::pow(4.0 / 3.0, double(N));
+    return std::sqrt(std::max(t2, 0.0));
+}
+
+struct distance_statistics
+{
+    // Smallest distance between any two points.
+    double min_distance;
+    // Mean distance from a point to its nearest neighbor.
+    double mean_nearest_distance;
+};
+
+// Nearest neighbor distances found by brute force in O(n^2 N); toroidal distance wraps around the unit cube.
+template<unsigned int N, typename T, typename Executor=sequential_executor>
+distance_statistics min_distance_statistics(const T* points, size_t count, bool toroidal=false, const Executor& executor=Executor{})
+{
+    static_assert(N > 0, "Number of dimensions must be greater than zero");
+    assert(count > 1);
+
+    const size_t num_tasks = std::min(count, detail::discrepancy_max_tasks);
+    const size_t task_size = (count + num_tasks - 1) / num_tasks;
+    std::vector<double> partial_min(num_tasks), partial_sum(num_tasks);
+    executor.parallel_for(num_tasks, [&](size_t task) {
+        const size_t begin = std::min(count, task * task_size);
+        const size_t end = std::min(count, begin + task_size);
+        double task_min = std::numeric_limits<double>::infinity();
+        double task_sum = 0.0;
+        for(size_t i=begin; i<end; ++i) {
+            const T* x = points + N * i;
+            double nearest_sqr = std::numeric_limits<double>::infinity();
+            for(size_t j=0; j<count; ++j) {
+                const T* y = points + N * j;
+                double distance_sqr = 0.0;
+                for(unsigned int k=0; k<N; ++k) {
+                    double d = std::abs(double(x[k]) - double(y[k]));
+                    d = toroidal ? std::min(d, 1.0 - d) : d;
+                    distance_sqr += d * d;
+                }
+                nearest_sqr = (j != i) ? std::min(nearest_sqr, distance_sqr) : nearest_sqr;
+            }
+            const double nearest = std::sqrt(nearest_sqr);
+            task_min = std::min(task_min, nearest);
+            task_sum += nearest;
+        }
+        partial_min[task] = task_min;
+        partial_sum[task] = task_sum;
+    });
+
+    distance_statistics result;
+    result.min_distance = *std::min_element(partial_min.begin(), partial_min.end());
+    result.mean_nearest_distance = std::accumulate(partial_sum.begin(), partial_sum.end(), 0.0) / count;
+    return result;
+}
+
+} // rsm
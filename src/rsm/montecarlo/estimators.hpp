@@ -0,0 +1,184 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+
+namespace rsm {
+
+namespace detail {
+
+// Sums a batch using independent partial sums so that the loop can be vectorized without reassociation.
+template<typename T, typename F>
+T batch_sum(const T* values, size_t count, F f)
+{
+    T partial[4] = { T(0), T(0), T(0), T(0) };
+    size_t i = 0;
+    for(; i + 4 <= count; i += 4) {
+        partial[0] += f(values[i+0]);
+        partial[1] += f(values[i+1]);
+        partial[2] += f(values[i+2]);
+        partial[3] += f(values[i+3]);
+    }
+    for(; i < count; ++i) {
+        partial[0] += f(values[i]);
+    }
+    return (partial[0] + partial[1]) + (partial[2] + partial[3]);
+}
+
+} // detail
+
+// Compensated (Kahan-Babuska-Neumaier) summation.
+// Compensation term is folded back into the sum after every addition so that it never grows
+// beyond rounding error of the sum itself and doesn't lose precision on very long runs.
+template<typename T>
+class compensated_sum
+{
+public:
+    void add(T value)
+    {
+        T t = m_sum + value;
+        if(std::abs(m_sum) >= std::abs(value)) {
+            m_compensation += (m_sum - t) + value;
+        }
+        else {
+            m_compensation += (value - t) + m_sum;
+        }
+        m_sum = t + m_compensation;
+        m_compensation -= m_sum - t;
+    }
+
+    void add(const T* values, size_t count)
+    {
+        for(size_t i=0; i<count; ++i) {
+            add(values[i]);
+        }
+    }
+
+    void merge(const compensated_sum& other)
+    {
+        add(other.m_sum);
+        add(other.m_compensation);
+    }
+
+    T value() const
+    {
+        return m_sum + m_compensation;
+    }
+
+private:
+    T m_sum = T(0);
+    T m_compensation = T(0);
+};
+
+// Running mean & variance estimator (Welford's algorithm).
+// Estimators accumulated independently (e.g. on different threads) can be merged in constant time
+// using parallel variance formula by Chan et al.
+template<typename T>
+class estimator
+{
+public:
+    void add(T value)
+    {
+        ++m_count;
+        T delta = value - m_mean;
+        m_mean += delta / T(m_count);
+        m_m2 += delta * (value - m_mean);
+    }
+
+    // Batch is reduced with a two-pass algorithm and then merged into the estimator.
+    void add(const T* values, size_t count)
+    {
+        if(count == 0) {
+            return;
+        }
+        const T batch_mean = detail::batch_sum(values, count, [](T x) { return x; }) / T(count);
+        const T batch_m2 = detail::batch_sum(values, count, [batch_mean](T x) { return (x - batch_mean) * (x - batch_mean); });
+        merge(count, batch_mean, batch_m2);
+    }
+
+    void merge(const estimator& other)
+    {
+        merge(other.m_count, other.m_mean, other.m_m2);
+    }
+
+    void reset()
+    {
+        m_count = 0;
+        m_mean = T(0);
+        m_m2 = T(0);
+    }
+
+    uint64_t count() const
+    {
+        return m_count;
+    }
+
+    T mean() const
+    {
+        return m_mean;
+    }
+
+    // Unbiased sample variance.
+    T variance() const
+    {
+        return (m_count > 1) ? m_m2 / T(m_count - 1) : T(0);
+    }
+
+    // Variance of the mean estimate.
+    T mean_variance() const
+    {
+        return (m_count > 0) ? variance() / T(m_count) : T(0);
+    }
+
+    T standard_error() const
+    {
+        return std::sqrt(mean_variance());
+    }
+
+    // Standard error relative to the mean; infinity if mean is zero, or NaN if standard error is zero as well
+    // (e.g. no samples yet), so that it never passes as converged by comparing against a tolerance.
+    T relative_error() const
+    {
+        const T error = standard_error();
+        if(m_mean != T(0)) {
+            return error / std::abs(m_mean);
+        }
+        return (error != T(0)) ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::quiet_NaN();
+    }
+
+    // Half-width of confidence interval around the mean using normal approximation.
+    // Default z value corresponds to 95% confidence level.
+    T confidence_interval(T z=T(1.959964)) const
+    {
+        return z * standard_error();
+    }
+
+private:
+    void merge(uint64_t count, T mean, T m2)
+    {
+        if(count == 0) {
+            return;
+        }
+        const uint64_t total = m_count + count;
+        const T delta = mean - m_mean;
+        const T weight = T(count) / T(total);
+        m_mean += delta * weight;
+        m_m2 += m2 + delta * delta * T(m_count) * weight;
+        m_count = total;
+    }
+
+    uint64_t m_count = 0;
+    T m_mean = T(0);
+    T m_m2 = T(0);
+};
+
+} // rsm
@@ -6,11 +6,37 @@
 
 #pragma once
 
+#include <cassert>
 #include <cstddef>
-#include <cmath>
 
 namespace rsm {
 
+namespace detail {
+
+// Integer power expanded to multiplications at compile time.
+template<int B>
+struct power_t
+{
+    static_assert(B > 0, "Exponent must be positive");
+    template<typename T>
+    static constexpr T eval(T x)
+    {
+        return x * power_t<B-1>::eval(x);
+    }
+};
+
+template<>
+struct power_t<1>
+{
+    template<typename T>
+    static constexpr T eval(T x)
+    {
+        return x;
+    }
+};
+
+} // detail
+
 template<typename T>
 constexpr T balance_heuristic(size_t n_f, T f_pdf, size_t n_g, T g_pdf)
 {
@@ -20,9 +46,126 @@ constexpr T balance_heuristic(size_t n_f, T f_pdf, size_t n_g, T g_pdf)
 template<typename T, int B=2>
 constexpr T power_heuristic(size_t n_f, T f_pdf, size_t n_g, T g_pdf)
 {
-    T pow_f = std::pow(n_f * f_pdf, B);
-    T pow_g = std::pow(n_g * g_pdf, B);
+    T pow_f = detail::power_t<B>::eval(n_f * f_pdf);
+    T pow_g = detail::power_t<B>::eval(n_g * g_pdf);
     return pow_f / (pow_f + pow_g);
 }
 
+// Multiple importance sampling weights for N strategies.
+// Weight is computed for a sample generated by strategy i, given its pdfs under all N strategies
+// (pdf[j]) and number of samples taken from each strategy (n[j]).
+
+template<unsigned int N, typename T>
+T balance_heuristic(unsigned int i, const size_t* n, const T* pdf)
+{
+    static_assert(N > 0, "Number of strategies must be greater than zero");
+    assert(i < N);
+    T sum = T(0);
+    for(unsigned int j=0; j<N; ++j) {
+        sum += n[j] * pdf[j];
+    }
+    return (sum > T(0)) ? (n[i] * pdf[i]) / sum : T(0);
+}
+
+template<unsigned int N, int B=2, typename T>
+T power_heuristic(unsigned int i, const size_t* n, const T* pdf)
+{
+    static_assert(N > 0, "Number of strategies must be greater than zero");
+    assert(i < N);
+    T sum = T(0);
+    T pow_i = T(0);
+    for(unsigned int j=0; j<N; ++j) {
+        const T pow_j = detail::power_t<B>::eval(n[j] * pdf[j]);
+        sum += pow_j;
+        pow_i = (j == i) ? pow_j : pow_i;
+    }
+    return (sum > T(0)) ? pow_i / sum : T(0);
+}
+
+// Weight is one if strategy i has the largest n*pdf product (ties are resolved in favor of lower index) and zero otherwise.
+template<unsigned int N, typename T>
+T maximum_heuristic(unsigned int i, const size_t* n, const T* pdf)
+{
+    static_assert(N > 0, "Number of strategies must be greater than zero");
+    assert(i < N);
+    const T q_i = n[i] * pdf[i];
+    for(unsigned int j=0; j<N; ++j) {
+        const T q_j = n[j] * pdf[j];
+        if(q_j > q_i || (q_j == q_i && j < i)) {
+            return T(0);
+        }
+    }
+    return (q_i > T(0)) ? T(1) : T(0);
+}
+
+// Strategies with n*pdf below alpha times the maximum are ignored, remaining ones are combined using balance heuristic.
+template<unsigned int N, typename T>
+T cutoff_heuristic(unsigned int i, const size_t* n, const T* pdf, T alpha=T(0.1))
+{
+    static_assert(N > 0, "Number of strategies must be greater than zero");
+    assert(i < N);
+    T q_max = T(0);
+    for(unsigned int j=0; j<N; ++j) {
+        const T q_j = n[j] * pdf[j];
+        q_max = (q_j > q_max) ? q_j : q_max;
+    }
+    const T q_i = n[i] * pdf[i];
+    const T cutoff = alpha * q_max;
+    if(q_i <= T(0) || q_i < cutoff) {
+        return T(0);
+    }
+    T sum = T(0);
+    for(unsigned int j=0; j<N; ++j) {
+        const T q_j = n[j] * pdf[j];
+        sum += (q_j >= cutoff) ? q_j : T(0);
+    }
+    return q_i / sum;
+}
+
+// Batch variants operate on a block of samples in structure-of-arrays layout: pdf[j][k] is pdf of k-th sample
+// under strategy j. Weights for strategy i are written to weights[k]. Loops over samples are branch-free
+// with the number of strategies known at compile time so that they can be vectorized.
+
+template<unsigned int N, typename T>
+void balance_heuristic(unsigned int i, const size_t* n, const T* const* pdf, T* weights, size_t count)
+{
+    static_assert(N > 0, "Number of strategies must be greater than zero");
+    assert(i < N);
+    T n_j[N];
+    const T* pdf_j[N];
+    for(unsigned int j=0; j<N; ++j) {
+        n_j[j] = T(n[j]);
+        pdf_j[j] = pdf[j];
+    }
+    for(size_t k=0; k<count; ++k) {
+        T sum = T(0);
+        for(unsigned int j=0; j<N; ++j) {
+            sum += n_j[j] * pdf_j[j][k];
+        }
+        const T q_i = n_j[i] * pdf_j[i][k];
+        weights[k] = (sum > T(0)) ? q_i / sum : T(0);
+    }
+}
+
+template<unsigned int N, int B=2, typename T>
+void power_heuristic(unsigned int i, const size_t* n, const T* const* pdf, T* weights, size_t count)
+{
+    static_assert(N > 0, "Number of strategies must be greater than zero");
+    assert(i < N);
+    T n_j[N];
+    const T* pdf_j[N];
+    for(unsigned int j=0; j<N; ++j) {
+        n_j[j] = T(n[j]);
+        pdf_j[j] = pdf[j];
+    }
+    for(size_t k=0; k<count; ++k) {
+        T sum = T(0);
+        for(unsigned int j=0; j<N; ++j) {
+            sum += detail::power_t<B>::eval(n_j[j] * pdf_j[j][k]);
+        }
+        const T pow_i = detail::power_t<B>::eval(n_j[i] * pdf_j[i][k]);
+        weights[k] = (sum > T(0)) ? pow_i / sum : T(0);
+    }
+}
+
 } // rsm
@@ -0,0 +1,434 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+#include "../executor.hpp"
+#include "../generators/splitmix64.hpp"
+#include "../samplers/random.hpp"
+#include "../samplers/cmj.hpp"
+#include "../samplers/halton.hpp"
+#include "../samplers/hammersley.hpp"
+#include "../samplers/lattice.hpp"
+#include "../samplers/stratified.hpp"
+#include "../distributions/ncube.hpp"
+#include "../distributions/disk.hpp"
+#include "../distributions/sphere.hpp"
+#include "../distributions/hemisphere.hpp"
+#include "estimators.hpp"
+
+namespace rsm {
+
+// Integration domains map uniform samples from [0..1)^sample_dims to points of the domain
+// and provide probability density of generated points. Custom domains need to provide the same interface.
+
+template<unsigned int N, typename U>
+struct ncube_domain
+{
+    using value_type = U;
+    static constexpr unsigned int sample_dims = N;
+    static constexpr unsigned int point_dims = N;
+
+    ncube_domain(const U* min, const U* max)
+    {
+        std::copy(min, min + N, this->min);
+        std::copy(max, max + N, this->max);
+        inv_volume = ncube_pdf<N>(min, max);
+    }
+    void warp(const U* u, U* p) const
+    {
+        ncube<N>(min, max, u, p);
+    }
+    U pdf(const U*) const
+    {
+        return inv_volume;
+    }
+
+    U min[N];
+    U max[N];
+    U inv_volume;
+};
+
+template<typename U>
+struct disk_domain
+{
+    using value_type = U;
+    static constexpr unsigned int sample_dims = 2;
+    static constexpr unsigned int point_dims = 2;
+
+    explicit disk_domain(U radius=U(1.0)) : radius(radius) {}
+    void warp(const U* u, U* p) const
+    {
+        disk_concentric(radius, u, p);
+    }
+    U pdf(const U*) const
+    {
+        return disk_pdf(radius);
+    }
+
+    U radius;
+};
+
+template<typename U>
+struct sphere_domain
+{
+    using value_type = U;
+    static constexpr unsigned int sample_dims = 2;
+    static constexpr unsigned int point_dims = 3;
+
+    explicit sphere_domain(U radius=U(1.0)) : radius(radius) {}
+    void warp(const U* u, U* p) const
+    {
+        sphere(radius, u, p);
+    }
+    U pdf(const U*) const
+    {
+        return sphere_pdf(radius);
+    }
+
+    U radius;
+};
+
+template<typename U>
+struct hemisphere_domain
+{
+    using value_type = U;
+    static constexpr unsigned int sample_dims = 2;
+    static constexpr unsigned int point_dims = 3;
+
+    explicit hemisphere_domain(U radius=U(1.0)) : radius(radius) {}
+    void warp(const U* u, U* p) const
+    {
+        hemisphere(radius, u, p);
+    }
+    U pdf(const U*) const
+    {
+        return hemisphere_pdf(radius);
+    }
+
+    U radius;
+};
+
+template<typename U>
+struct hemisphere_cosine_domain
+{
+    using value_type = U;
+    static constexpr unsigned int sample_dims = 2;
+    static constexpr unsigned int point_dims = 3;
+
+    explicit hemisphere_cosine_domain(U radius=U(1.0)) : radius(radius) {}
+    void warp(const U* u, U* p) const
+    {
+        hemisphere_cosine_concentric(radius, u, p);
+    }
+    U pdf(const U* p) const
+    {
+        return hemisphere_cosine_pdf(radius, p[2] / radius);
+    }
+
+    U radius;
+};
+
+namespace detail {
+
+// Samples are processed in fixed-size chunks so that results don't depend on the number of threads.
+constexpr size_t integrate_chunk_size = 4096;
+constexpr size_t integrate_batch_size = 256;
+
+inline uint64_t chunk_seed(uint64_t seed, size_t first_sample)
+{
+    return splitmix64(seed + first_sample * 0x9e3779b97f4a7c15ull)();
+}
+
+// Sample sources provide independent, deterministic sample streams for every chunk of the integration domain.
+// Chunk streams depend only on the index of the first sample in the chunk.
+template<unsigned int N, typename U, typename Sampler, typename Generator>
+struct integration_source;
+
+// Progressive sources can be extended with more samples without regenerating the ones already used.
+template<typename Sampler>
+struct is_progressive : std::true_type {};
+
+template<unsigned int N, typename U, typename Generator>
+struct integration_source<N, U, random_sampler, Generator>
+{
+    struct chunk
+    {
+        void fill(U* buffer, size_t count)
+        {
+            sample<N>(random_sampler{}, generator, buffer, count);
+        }
+        Generator generator;
+    };
+
+    integration_source(random_sampler, size_t, uint64_t seed) : seed(seed) {}
+    chunk begin_chunk(size_t first_sample) const
+    {
+        return chunk{Generator(chunk_seed(seed, first_sample))};
+    }
+
+    uint64_t seed;
+};
+
+// Low discrepancy samplers are index-addressable: every chunk continues the sequence at its first index.
+template<unsigned int N, typename U, typename Sampler>
+struct integration_source_lds
+{
+    struct chunk
+    {
+        void fill(U* buffer, size_t count)
+        {
+            sample<N>(sampler, buffer, count);
+        }
+        Sampler sampler;
+    };
+
+    integration_source_lds(const Sampler& sampler) : sampler(sampler) {}
+    chunk begin_chunk(size_t first_sample) const
+    {
+        chunk c{sampler};
+        c.sampler.offset += first_sample;
+        return c;
+    }
+
+    Sampler sampler;
+};
+
+template<unsigned int N, typename U, unsigned int MaxDim, typename Generator>
+struct integration_source<N, U, halton_sampler<MaxDim>, Generator> : integration_source_lds<N, U, halton_sampler<MaxDim>>
+{
+    integration_source(const halton_sampler<MaxDim>& sampler, size_t, uint64_t)
+        : integration_source_lds<N, U, halton_sampler<MaxDim>>(sampler)
+    {}
+};
+
+template<unsigned int N, typename U, unsigned int MaxDim, typename FloatType, typename Generator>
+struct integration_source<N, U, hammersley_sampler<MaxDim, FloatType>, Generator> : integration_source_lds<N, U, hammersley_sampler<MaxDim, FloatType>>
+{
+    integration_source(const hammersley_sampler<MaxDim, FloatType>& sampler, size_t count, uint64_t)
+        : integration_source_lds<N, U, hammersley_sampler<MaxDim, FloatType>>(sampler)
+    {
+        assert(sampler.offset + count <= sampler.max_samples());
+        (void)count;
+    }
+};
+
+template<unsigned int N, typename U, unsigned int MaxDim, typename FloatType, typename Generator>
+struct integration_source<N, U, lattice_sampler<MaxDim, FloatType>, Generator> : integration_source_lds<N, U, lattice_sampler<MaxDim, FloatType>>
+{
+    integration_source(const lattice_sampler<MaxDim, FloatType>& sampler, size_t count, uint64_t)
+        : integration_source_lds<N, U, lattice_sampler<MaxDim, FloatType>>(sampler)
+    {
+        assert(sampler.offset + count <= sampler.max_samples());
+        (void)count;
+    }
+};
+
+template<unsigned int N, typename U, unsigned int MaxDim, typename Generator>
+struct integration_source<N, U, cmj_sampler<MaxDim>, Generator> : integration_source_lds<N, U, cmj_sampler<MaxDim>>
+{
+    integration_source(const cmj_sampler<MaxDim>& sampler, size_t count, uint64_t)
+        : integration_source_lds<N, U, cmj_sampler<MaxDim>>(sampler)
+    {
+        assert(sampler.offset + count <= sampler.max_samples());
+        (void)count;
+    }
+};
+
+// Full stratified sets without shuffling use counter-based jitter so every chunk is generated independently.
+// Otherwise (LHS fallback or shuffled strata) the set can only be generated as a whole, so it's generated up front and then split into chunks.
+template<unsigned int N, typename U, unsigned int MaxDim, typename Generator>
+struct integration_source<N, U, stratified_sampler<MaxDim>, Generator>
+{
+    struct chunk
+    {
+        void fill(U* buffer, size_t count)
+        {
+            if(samples) {
+                std::copy(samples, samples + N * count, buffer);
+                samples += N * count;
+            }
+            else {
+                sample_strata<N>(*sampler, seed, buffer, first_sample, count);
+                first_sample += count;
+            }
+        }
+        const U* samples;
+        const stratified_sampler<MaxDim>* sampler;
+        uint64_t seed;
+        size_t first_sample;
+    };
+
+    integration_source(const stratified_sampler<MaxDim>& sampler, size_t count, uint64_t seed)
+        : sampler(sampler)
+        , seed(seed)
+    {
+        if(count != sampler.total_strata(N) || (sampler.options & opt::shuffle)) {
+            samples.resize(N * count);
+            Generator generator(seed);
+            sample<N>(sampler, generator, samples.data(), count);
+        }
+    }
+    chunk begin_chunk(size_t first_sample) const
+    {
+        if(samples.empty()) {
+            return chunk{nullptr, &sampler, seed, first_sample};
+        }
+        return chunk{&samples[N * first_sample], nullptr, 0, 0};
+    }
+
+    stratified_sampler<MaxDim> sampler;
+    uint64_t seed;
+    std::vector<U> samples;
+};
+
+// Prefixes of fixed-size point sets are not well distributed.
+template<unsigned int MaxDim>
+struct is_progressive<stratified_sampler<MaxDim>> : std::false_type {};
+template<unsigned int MaxDim, typename FloatType>
+struct is_progressive<hammersley_sampler<MaxDim, FloatType>> : std::false_type {};
+template<unsigned int MaxDim, typename FloatType>
+struct is_progressive<lattice_sampler<MaxDim, FloatType>> : std::false_type {};
+template<unsigned int MaxDim>
+struct is_progressive<cmj_sampler<MaxDim>> : std::false_type {};
+
+template<typename Domain, typename F, typename Source, typename Executor>
+estimator<typename Domain::value_type> integrate_range(F& f, const Source& source, const Domain& domain,
+                                                       size_t first_sample, size_t count, const Executor& executor)
+{
+    using U = typename Domain::value_type;
+    constexpr unsigned int N = Domain::sample_dims;
+    constexpr unsigned int P = Domain::point_dims;
+
+    const size_t num_chunks = (count + integrate_chunk_size - 1) / integrate_chunk_size;
+    std::vector<estimator<U>> chunk_estimators(num_chunks);
+
+    executor.parallel_for(num_chunks, [&](size_t chunk_index) {
+        const size_t chunk_begin = first_sample + chunk_index * integrate_chunk_size;
+        const size_t chunk_end = std::min(first_sample + count, chunk_begin + integrate_chunk_size);
+        auto chunk = source.begin_chunk(chunk_begin);
+
+        U u[N * integrate_batch_size];
+        U values[integrate_batch_size];
+        for(size_t batch_begin=chunk_begin; batch_begin<chunk_end; batch_begin += integrate_batch_size) {
+            const size_t batch_count = std::min(integrate_batch_size, chunk_end - batch_begin);
+            chunk.fill(u, batch_count);
+            for(size_t i=0; i<batch_count; ++i) {
+                U p[P];
+                domain.warp(&u[N * i], p);
+                const U pdf = domain.pdf(p);
+                values[i] = (pdf > U(0.0)) ? U(f(static_cast<const U*>(p))) / pdf : U(0.0);
+            }
+            chunk_estimators[chunk_index].add(values, batch_count);
+        }
+    });
+
+    estimator<U> result;
+    for(const auto& chunk_estimator : chunk_estimators) {
+        result.merge(chunk_estimator);
+    }
+    return result;
+}
+
+} // detail
+
+// Estimates integral of f over the domain using count samples drawn from sampler.
+// Integrand is called as f(const U* p) with a point of Domain::point_dims dimensions.
+// Work is split into chunks of consecutive sample indices executed in parallel by the executor;
+// chunk estimates are merged in fixed order so the result is identical regardless of the executor used.
+// Random and stratified samplers draw from Generator instances seeded deterministically from seed.
+// Fixed-size point sets (hammersley, lattice, cmj) must have at least count samples left past their offset;
+// their indices would otherwise wrap around and repeat points, understating the standard error.
+template<typename Generator=default_generator, typename F, typename Sampler, typename Domain, typename Executor=sequential_executor>
+estimator<typename Domain::value_type> integrate(F f, const Sampler& sampler, const Domain& domain, size_t count,
+                                                 const Executor& executor=Executor{}, uint64_t seed=0)
+{
+    using source_type = detail::integration_source<Domain::sample_dims, typename Domain::value_type, Sampler, Generator>;
+    const source_type source(sampler, count, seed);
+    return detail::integrate_range<Domain>(f, source, domain, 0, count, executor);
+}
+
+struct adaptive_options
+{
+    // Integration stops once standard error of the estimate drops below
+    // max(relative_tolerance * |estimate|, absolute_tolerance) and is nonzero.
+    double relative_tolerance = 0.01;
+    double absolute_tolerance = 0.0;
+    size_t min_samples = 64;
+    size_t max_samples = size_t(1) << 24;
+    // Wall clock budget in seconds (zero means unlimited).
+    double time_budget = 0.0;
+};
+
+template<typename U>
+struct adaptive_result
+{
+    estimator<U> estimate;
+    U error;
+    bool converged;
+};
+
+// Progressively draws samples until requested tolerance, sample count or time budget is reached.
+// Every round continues the sample sequence where the previous one ended (requires a progressive sampler,
+// e.g. random_sampler or halton_sampler) and is sized from the current error estimate, at most doubling the sample count.
+// Error is the standard error of independent samples; for low discrepancy samplers it's only a heuristic.
+// Zero error (all samples so far are equal) never counts as convergence since it's just as likely to come from
+// a sparse integrand not hit yet as from a constant one; constant integrands run until max_samples or time budget.
+template<typename Generator=default_generator, typename F, typename Sampler, typename Domain, typename Executor=sequential_executor>
+adaptive_result<typename Domain::value_type> integrate_adaptive(F f, const Sampler& sampler, const Domain& domain, const adaptive_options& options,
+                                                                const Executor& executor=Executor{}, uint64_t seed=0)
+{
+    static_assert(detail::is_progressive<Sampler>::value, "Adaptive integration requires a progressive sampler");
+    assert(options.min_samples > 0 && options.min_samples <= options.max_samples);
+
+    using U = typename Domain::value_type;
+    using source_type = detail::integration_source<Domain::sample_dims, U, Sampler, Generator>;
+    using clock = std::chrono::steady_clock;
+
+    const source_type source(sampler, options.max_samples, seed);
+    const auto start_time = clock::now();
+
+    adaptive_result<U> result;
+    result.converged = false;
+
+    size_t round_samples = options.min_samples;
+    while(true) {
+        result.estimate.merge(detail::integrate_range<Domain>(f, source, domain, result.estimate.count(), round_samples, executor));
+        result.error = result.estimate.standard_error();
+
+        const size_t num_samples = result.estimate.count();
+        const double tolerance = std::max(options.relative_tolerance * std::abs(double(result.estimate.mean())), options.absolute_tolerance);
+        if(result.error > U(0.0) && result.error <= tolerance) {
+            result.converged = true;
+            break;
+        }
+        if(num_samples >= options.max_samples) {
+            break;
+        }
+        if(options.time_budget > 0.0 && std::chrono::duration<double>(clock::now() - start_time).count() >= options.time_budget) {
+            break;
+        }
+
+        // Standard error decreases as 1/sqrt(n).
+        const double ratio = double(result.error) / tolerance;
+        const double required_samples = (tolerance > 0.0 && result.error > U(0.0)) ? num_samples * ratio * ratio : 2.0 * num_samples;
+        round_samples = static_cast<size_t>(std::min(required_samples, 2.0 * num_samples)) - num_samples;
+        round_samples = std::max(round_samples, options.min_samples);
+        round_samples = std::min(round_samples, options.max_samples - num_samples);
+    }
+    return result;
+}
+
+} // rsm
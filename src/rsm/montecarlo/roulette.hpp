@@ -0,0 +1,94 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+
+#include "../detail/hash.hpp"
+#include "../samplers/halton.hpp"
+
+namespace rsm {
+
+template<typename T>
+struct roulette_result
+{
+    // Number of path copies to continue with (zero means the path is terminated).
+    unsigned int count;
+    // Weight to apply to every continued path.
+    T weight;
+};
+
+// Russian roulette: path survives with given probability and is reweighted by its inverse.
+// Returns weight of the path (zero if terminated).
+template<typename T>
+T russian_roulette(T survival_probability, T u)
+{
+    const T q = std::min(survival_probability, T(1));
+    return (q > T(0) && u < q) ? T(1) / q : T(0);
+}
+
+// Combined Russian roulette (factor < 1) and splitting (factor > 1).
+// Path is continued floor(factor + u) times with weight 1/factor each so that the expected weight is preserved.
+template<typename T>
+roulette_result<T> roulette_split(T factor, T u, unsigned int max_count=16)
+{
+    assert(max_count > 0);
+    if(!(factor > T(0))) {
+        return { 0, T(0) };
+    }
+    const T clamped_factor = std::min(factor, T(max_count));
+    const unsigned int count = static_cast<unsigned int>(clamped_factor + u);
+    return { count, (count > 0) ? T(1) / clamped_factor : T(0) };
+}
+
+// Survival probability proportional to path throughput (e.g. its luminance or maximum component).
+template<typename T>
+T throughput_survival(T throughput, T min_probability=T(0.05))
+{
+    return std::max(std::min(throughput, T(1)), min_probability);
+}
+
+// Efficiency-optimized roulette & splitting factor using a weight window centered at the ratio of estimated
+// pixel value to expected radiance arriving along the path (see: J. Vorba, J. Křivánek,
+// "Adjoint-Driven Russian Roulette and Splitting in Light Transport Simulation").
+// Paths with throughput below the window are rouletted, those above are split; use with roulette_split().
+template<typename T>
+T weight_window_factor(T throughput, T expected_radiance, T pixel_estimate, T window_size=T(5))
+{
+    if(!(expected_radiance > T(0)) || !(pixel_estimate > T(0))) {
+        return T(1);
+    }
+    const T center = pixel_estimate / expected_radiance;
+    const T lower = T(2) * center / (T(1) + window_size);
+    const T upper = lower * window_size;
+    if(throughput < lower) {
+        return throughput / lower;
+    }
+    if(throughput > upper) {
+        return throughput / upper;
+    }
+    return T(1);
+}
+
+// Decision variates. To keep dimension allocation consistent every termination decision should
+// consume a designated dimension of a low discrepancy sampler or a counter-based stream.
+
+template<typename T, unsigned int MaxDim>
+T roulette_variate(const halton_sampler<MaxDim>& sampler, unsigned int dim, uint64_t index)
+{
+    return detail::sample_halton<T>(sampler, dim, index);
+}
+
+template<typename T>
+T roulette_variate(uint64_t seed, uint64_t path_index, unsigned int depth)
+{
+    return detail::hash_variate<T>(detail::hash(seed, path_index, depth));
+}
+
+} // rsm
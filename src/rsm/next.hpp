@@ -10,6 +10,7 @@
 #include <cstdint>
 
 #include "detail/common.hpp"
+#include "stats.hpp"
 
 namespace rsm {
 namespace detail {
@@ -33,6 +34,7 @@ inline uint32_t next(next_value_t<uint32_t>, Generator& generator, uint32_t rang
     if(l < range) {
         uint32_t t = (-range) % range;
         while(l < t) {
+            RSM_STATS_ADD(bounded32_retries, 1);
             x = static_cast<uint32_t>(generator() - Generator::min());
             m = uint64_t(x) * uint64_t(range);
             l = uint32_t(m);
@@ -54,21 +56,42 @@ inline uint64_t next(next_value_t<uint64_t>, Generator& generator, uint64_t rang
     // Debiased modulo (once) method.
     // Lemire's method is significantly faster but in 64-bit output case it uses 128-bit integeres.
     // We can't rely on those being available (especially when compiling for CUDA).
-    uint64_t x, r;
-    do {
+    uint64_t x = static_cast<uint64_t>(generator() - Generator::min());
+    uint64_t r = x % range;
+    while(x - r > uint64_t(-range)) {
+        RSM_STATS_ADD(bounded64_retries, 1);
         x = static_cast<uint64_t>(generator() - Generator::min());
         r = x % range;
-    } while(x - r > uint64_t(-range));
+    }
     return r;
 }
 
+// Maps raw generator output to a variate in [0..1). Specialized for generators with a faster exact mapping;
+// generator adapters (e.g. buffered_generator) specialize it to use the mapping of the generator they wrap.
 template<typename Generator>
-inline float next(next_value_t<float>, Generator& generator)
+struct variate_conversion
 {
+    using result_type = typename Generator::result_type;
+
     // This method introduces slight bias but we need it to be fast & general enough to handle various min/max generator values.
     // See: http://mumble.net/~campbell/tmp/random_real.c
-    constexpr float inv_range = 1.0 / (Generator::max() - Generator::min());
-    return detail::variate<float>((generator() - Generator::min()) * inv_range);
+    static float to_float(result_type value)
+    {
+        constexpr float inv_range = 1.0 / (Generator::max() - Generator::min());
+        return detail::variate<float>((value - Generator::min()) * inv_range);
+    }
+
+    static double to_double(result_type value)
+    {
+        constexpr double inv_range = 1.0 / (Generator::max() - Generator::min());
+        return detail::variate<double>((value - Generator::min()) * inv_range);
+    }
+};
+
+template<typename Generator>
+inline float next(next_value_t<float>, Generator& generator)
+{
+    return variate_conversion<Generator>::to_float(generator());
 }
 
 template<typename Generator>
@@ -80,10 +103,7 @@ inline float next(next_value_t<float>, Generator& generator, float scale)
 template<typename Generator>
 inline double next(next_value_t<double>, Generator& generator)
 {
-    // This method introduces slight bias but we need it to be fast & general enough to handle various min/max generator values.
-    // See: http://mumble.net/~campbell/tmp/random_real.c
-    constexpr double inv_range = 1.0 / (Generator::max() - Generator::min());
-    return detail::variate<double>((generator() - Generator::min()) * inv_range);
+    return variate_conversion<Generator>::to_double(generator());
 }
 
 template<typename Generator>
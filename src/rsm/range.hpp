@@ -8,11 +8,99 @@
 
 #include <cassert>
 #include <cstddef>
+#include <algorithm>
 #include <array>
 #include <iterator>
+#include <utility>
 
 namespace rsm {
 
+// Flat N-dimensional index space with the first dimension varying fastest.
+// Elements are addressed by linear index, so the space can be split into arbitrary sub-ranges for parallel traversal.
+// Traversal is done in spans which are contiguous runs along the first dimension; within a span
+// all other indices stay constant so the inner loop is a plain loop over index[0].
+template<unsigned int N>
+class grid_t
+{
+    static_assert(N > 0, "Number of dimensions must be greater than zero");
+public:
+    using index_type = std::array<size_t, N>;
+
+    explicit grid_t(const index_type& size)
+        : m_size(size)
+    {}
+
+    size_t size(unsigned int dim) const
+    {
+        assert(dim < N);
+        return m_size[dim];
+    }
+
+    size_t total_size() const
+    {
+        size_t s = m_size[0];
+        for(unsigned int dim=1; dim<N; ++dim) {
+            s *= m_size[dim];
+        }
+        return s;
+    }
+
+    index_type index(size_t linear_index) const
+    {
+        index_type result;
+        for(unsigned int dim=0; dim<N; ++dim) {
+            result[dim] = linear_index % m_size[dim];
+            linear_index /= m_size[dim];
+        }
+        return result;
+    }
+
+    size_t linear_index(const index_type& index) const
+    {
+        size_t result = index[N-1];
+        for(unsigned int dim=N-1; dim>0; --dim) {
+            result = result * m_size[dim-1] + index[dim-1];
+        }
+        return result;
+    }
+
+    // Calls f(first, index, count) for every span within [begin, end) where first is the linear index
+    // of the first element of the span, index is its N-dimensional index and count is its length.
+    template<typename F>
+    void for_each_span(size_t begin, size_t end, F&& f) const
+    {
+        assert(begin <= end && end <= total_size());
+        if(begin == end) {
+            return;
+        }
+        index_type current = index(begin);
+        for(size_t first=begin; first<end;) {
+            const size_t count = std::min(m_size[0] - current[0], end - first);
+            f(first, current, count);
+            first += count;
+            current[0] = 0;
+            for(unsigned int dim=1; dim<N && ++current[dim] == m_size[dim]; ++dim) {
+                current[dim] = 0;
+            }
+        }
+    }
+
+    template<typename F>
+    void for_each_span(F&& f) const
+    {
+        for_each_span(0, total_size(), std::forward<F>(f));
+    }
+
+private:
+    index_type m_size;
+};
+
+template<unsigned int N>
+grid_t<N> grid(const std::array<size_t, N>& size)
+{
+    return grid_t<N>{size};
+}
+
 template<unsigned int N, typename T>
 class range_t
 {
@@ -85,10 +173,10 @@ public:
 
         value_type m_it;
         std::array<size_t, N> m_size;
-        uint16_t m_stride;
+        size_t m_stride;
     };
 
-    range_t(T* buffer, const std::array<size_t, N>& size, uint16_t stride=1)
+    range_t(T* buffer, const std::array<size_t, N>& size, size_t stride=1)
         : m_buffer(buffer)
         , m_size(size)
         , m_stride(stride)
@@ -114,21 +202,47 @@ public:
 
     size_t total_size() const
     {
-        size_t s = m_size[0];
-        for(size_t dim=1; dim<N; ++dim) {
-            s *= m_size[dim];
-        }
-        return s;
+        return grid_t<N>{m_size}.total_size();
+    }
+
+    size_t stride() const
+    {
+        return m_stride;
+    }
+
+    // Random access to element with given linear index.
+    typename iterator::value_type at(size_t linear_index) const
+    {
+        assert(linear_index < total_size());
+        return { m_buffer + linear_index * m_stride, grid_t<N>{m_size}.index(linear_index) };
+    }
+
+    // Calls f(values, index, count) for every span of elements within linear range [begin, end) (see grid_t).
+    // Consecutive elements of a span are stride() elements apart in the buffer.
+    template<typename F>
+    void for_each_span(size_t begin, size_t end, F&& f) const
+    {
+        T* buffer = m_buffer;
+        const size_t stride = m_stride;
+        grid_t<N>{m_size}.for_each_span(begin, end, [buffer, stride, &f](size_t first, const std::array<size_t, N>& index, size_t count) {
+            f(buffer + first * stride, index, count);
+        });
+    }
+
+    template<typename F>
+    void for_each_span(F&& f) const
+    {
+        for_each_span(0, total_size(), std::forward<F>(f));
     }
 
 private:
     T* m_buffer;
     std::array<size_t, N> m_size;
-    uint16_t m_stride;
+    size_t m_stride;
 };
 
 template<unsigned int N, typename T>
-range_t<N, T> range(T* buffer, const std::array<size_t, N>& size, uint16_t stride=1)
+range_t<N, T> range(T* buffer, const std::array<size_t, N>& size, size_t stride=1)
 {
     return range_t<N, T>{buffer, size, stride};
 }
@@ -6,11 +6,15 @@
 
 #pragma once
 
+#include "convert.hpp"
+#include "executor.hpp"
 #include "init.hpp"
+#include "layout.hpp"
 #include "lds.hpp"
 #include "next.hpp"
 #include "options.hpp"
 #include "range.hpp"
+#include "stats.hpp"
 #include "utils.hpp"
 
 #include "generators/stlcompat.hpp"
@@ -18,16 +22,34 @@
 #include "generators/splitmix64.hpp"
 #include "generators/xoroshiro64s.hpp"
 #include "generators/xoroshiro128p.hpp"
+#include "generators/buffered.hpp"
 
 #include "samplers/random.hpp"
+#include "samplers/cmj.hpp"
 #include "samplers/halton.hpp"
+#include "samplers/halton_pixel.hpp"
 #include "samplers/hammersley.hpp"
+#include "samplers/lattice.hpp"
+#include "samplers/padded.hpp"
+#include "samplers/poisson.hpp"
 #include "samplers/stratified.hpp"
 #include "samplers/lhs.hpp"
 
 #include "distributions/ncube.hpp"
+#include "distributions/nsphere.hpp"
+#include "distributions/simplex.hpp"
 #include "distributions/disk.hpp"
 #include "distributions/sphere.hpp"
 #include "distributions/hemisphere.hpp"
+#include "distributions/microfacet.hpp"
+#include "distributions/spherical.hpp"
+#include "distributions/triangle.hpp"
+#include "distributions/frame.hpp"
+#include "distributions/cone.hpp"
+#include "distributions/hierarchical.hpp"
 
+#include "montecarlo/discrepancy.hpp"
+#include "montecarlo/estimators.hpp"
 #include "montecarlo/heuristics.hpp"
+#include "montecarlo/integrate.hpp"
+#include "montecarlo/roulette.hpp"
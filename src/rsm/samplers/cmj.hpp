@@ -0,0 +1,194 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+
+#include "../detail/common.hpp"
+#include "../detail/hash.hpp"
+#include "../detail/output.hpp"
+
+namespace rsm {
+
+namespace detail {
+
+// Pseudo-random permutation of [0..length) selected by pattern, evaluated in constant time
+// by cycle-walking a hash restricted to the next power of two.
+// See: A. Kensler, "Correlated Multi-Jittered Sampling", Pixar Technical Memo 13-01.
+inline uint32_t cmj_permute(uint32_t i, uint32_t length, uint32_t pattern)
+{
+    uint32_t w = length - 1;
+    w |= w >> 1;
+    w |= w >> 2;
+    w |= w >> 4;
+    w |= w >> 8;
+    w |= w >> 16;
+    do {
+        i ^= pattern; i *= 0xe170893d;
+        i ^= pattern >> 16;
+        i ^= (i & w) >> 4;
+        i ^= pattern >> 8; i *= 0x0929eb3f;
+        i ^= pattern >> 23;
+        i ^= (i & w) >> 1; i *= 1 | pattern >> 27;
+        i *= 0x6935fa69;
+        i ^= (i & w) >> 11; i *= 0x74dcb303;
+        i ^= (i & w) >> 2; i *= 0x9e501cc3;
+        i ^= (i & w) >> 2; i *= 0xc860a3df;
+        i &= w;
+        i ^= i >> 5;
+    } while(i >= length);
+    return (i + pattern) % length;
+}
+
+template<typename T>
+T cmj_jitter(uint32_t i, uint32_t pattern)
+{
+    i ^= pattern;
+    i ^= i >> 17; i ^= i >> 10; i *= 0xb36534e5;
+    i ^= i >> 12; i ^= i >> 21; i *= 0x93fc4795;
+    i ^= 0xdf6e307f; i ^= i >> 17; i *= 1 | pattern >> 18;
+    return T(i * (1.0 / 4294967808.0));
+}
+
+} // detail
+
+// Correlated multi-jittered sampler: every pair of dimensions forms an m x n multi-jittered set which is
+// stratified in 2D and in both 1D projections. Any sample of the set is computed in constant time without
+// precomputation and the number of samples doesn't need to be a product of strata counts.
+// Each pair of dimensions uses a different pattern derived from seed; change seed (e.g. per pixel) to decorrelate sets.
+// Sample indices wrap around modulo num_samples, so drawing more than max_samples() repeats the set.
+// See: A. Kensler, "Correlated Multi-Jittered Sampling", Pixar Technical Memo 13-01.
+template<unsigned int MaxDim>
+struct cmj_sampler
+{
+    static_assert(MaxDim > 0, "Maximum dimension must be greater than zero");
+
+    // Aspect ratio of strata grid (m/n) can be adjusted to match the domain.
+    explicit cmj_sampler(uint32_t num_samples, uint32_t seed=0, float aspect=1.0f, uint64_t offset=0)
+        : num_samples(num_samples)
+        , seed(seed)
+        , offset(offset)
+    {
+        assert(num_samples > 0 && aspect > 0.0f);
+        m = std::max<uint32_t>(static_cast<uint32_t>(std::sqrt(num_samples * aspect)), 1);
+        n = (num_samples + m - 1) / m;
+    }
+
+    size_t max_samples() const
+    {
+        return num_samples;
+    }
+
+    uint32_t num_samples;
+    uint32_t m;
+    uint32_t n;
+    uint32_t seed;
+    mutable uint64_t offset;
+};
+
+namespace detail {
+
+template<typename T, unsigned int MaxDim>
+void sample_cmj_pair(const cmj_sampler<MaxDim>& sampler, unsigned int pair, uint64_t index, T* value)
+{
+    const uint32_t p = static_cast<uint32_t>(hash(sampler.seed, pair));
+    const uint32_t s = cmj_permute(static_cast<uint32_t>(index % sampler.num_samples), sampler.num_samples, p * 0x51633e2d);
+    const uint32_t sx = cmj_permute(s % sampler.m, sampler.m, p * 0x68bc21eb);
+    const uint32_t sy = cmj_permute(s / sampler.m, sampler.n, p * 0x02e5be93);
+    const T jx = cmj_jitter<T>(s, p * 0x967a889b);
+    const T jy = cmj_jitter<T>(s, p * 0x368cc8b7);
+    value[0] = variate<T>((sx + (sy + jx) / sampler.n) / sampler.m);
+    value[1] = variate<T>((s + jy) / sampler.num_samples);
+}
+
+template<typename T, unsigned int MaxDim>
+T sample_cmj(const cmj_sampler<MaxDim>& sampler, unsigned int dim, uint64_t index)
+{
+    assert(dim < MaxDim);
+    T value[2];
+    sample_cmj_pair<T>(sampler, dim / 2, index, value);
+    return value[dim % 2];
+}
+
+template<unsigned int N, typename Scalar, typename Output, typename Buffer, unsigned int MaxDim>
+void sample_cmj(const cmj_sampler<MaxDim>& sampler, Buffer buffer, size_t count)
+{
+    static_assert(N > 0 && N <= MaxDim, "Requested number of dimensions is not in valid range");
+
+    for(size_t i=0; i<count; ++i) {
+        const uint64_t index = sampler.offset + i;
+        for(unsigned int dim=0; dim<N; dim += 2) {
+            Scalar value[2];
+            sample_cmj_pair<Scalar>(sampler, dim / 2, index, value);
+            Output::store(buffer, i, dim, value[0]);
+            if(dim + 1 < N) {
+                Output::store(buffer, i, dim + 1, value[1]);
+            }
+        }
+    }
+    sampler.offset += count;
+}
+
+} // detail
+
+template<typename T, unsigned int MaxDim>
+T sample(const cmj_sampler<MaxDim>& sampler)
+{
+    return detail::sample_cmj<T>(sampler, 0, sampler.offset++);
+}
+
+template<unsigned int N, typename T, unsigned int MaxDim>
+T sample_vec(const cmj_sampler<MaxDim>& sampler)
+{
+    T v;
+    using Scalar = typename std::decay<decltype(v[0])>::type;
+    detail::sample_cmj<N, Scalar, detail::vector_output>(sampler, &v, 1);
+    return v;
+}
+
+template<unsigned int N, typename T, unsigned int MaxDim>
+void sample(const cmj_sampler<MaxDim>& sampler, T* buffer, size_t count=0)
+{
+    using Scalar = typename std::decay<decltype(buffer[0])>::type;
+    size_t requested_samples = (count > 0) ? count : sampler.max_samples();
+    detail::sample_cmj<N, Scalar, detail::interleaved_output<N>>(sampler, buffer, requested_samples);
+}
+
+template<typename T, unsigned int MaxDim>
+void sample(const cmj_sampler<MaxDim>& sampler, T* buffer, size_t count=0)
+{
+    sample<1>(sampler, buffer, count);
+}
+
+template<unsigned int N, typename T, unsigned int MaxDim>
+void sample_vec(const cmj_sampler<MaxDim>& sampler, T* buffer, size_t count=0)
+{
+    using Scalar = typename std::decay<decltype((*buffer)[0])>::type;
+    size_t requested_samples = (count > 0) ? count : sampler.max_samples();
+    detail::sample_cmj<N, Scalar, detail::vector_output>(sampler, buffer, requested_samples);
+}
+
+template<unsigned int N, typename T, unsigned int MaxDim>
+void sample(const cmj_sampler<MaxDim>& sampler, const soa_buffer<T, N>& buffer, size_t count=0)
+{
+    size_t requested_samples = (count > 0) ? count : sampler.max_samples();
+    detail::sample_cmj<N, T, detail::soa_output>(sampler, buffer, requested_samples);
+}
+
+template<unsigned int N, typename T, unsigned int MaxDim>
+void sample(const cmj_sampler<MaxDim>& sampler, const strided_buffer<T>& buffer, size_t count=0)
+{
+    size_t requested_samples = (count > 0) ? count : sampler.max_samples();
+    detail::sample_cmj<N, T, detail::strided_output>(sampler, buffer, requested_samples);
+}
+
+} // rsm
@@ -9,11 +9,14 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <algorithm>
 #include <array>
 #include <type_traits>
 
 #include "../detail/common.hpp"
+#include "../detail/output.hpp"
 #include "../lds.hpp"
+#include "../stats.hpp"
 
 namespace rsm {
 
@@ -49,44 +52,94 @@ T sample_halton(const halton_sampler<MaxDim>& sampler, unsigned int dim, uint64_
 {
     assert(dim < MaxDim);
     unsigned int dim_offset = sampler.base_dim + dim;
+    RSM_STATS_ADD_DIMENSION(dim_offset, 1);
     return detail::variate<T>(radical_inverse<T>(dim_offset, sampler.base[dim], sampler.permutation[dim], offset));
 }
 
+template<unsigned int N, typename Scalar, typename Output, typename Buffer, unsigned int MaxDim>
+void sample_halton_direct(const halton_sampler<MaxDim>& sampler, Buffer buffer, size_t count)
+{
+    auto kernel = radical_inverse_kernel<Scalar, N, Output>::template lookup<Buffer>(sampler.base_dim);
+    if(kernel) {
+        kernel(sampler.permutation.data(), sampler.offset, count, buffer);
+        for(unsigned int dim=0; dim<N; ++dim) {
+            RSM_STATS_ADD_DIMENSION(sampler.base_dim + dim, count);
+        }
+    }
+    else {
+        for(size_t i=0; i<count; ++i) {
+            for(unsigned int dim=0; dim<N; ++dim) {
+                Output::store(buffer, i, dim, sample_halton<Scalar>(sampler, dim, sampler.offset + i));
+            }
+        }
+    }
+}
+
+// Consecutive offsets are generated incrementally from per-dimension digit state.
+// Buffer is filled in blocks to keep all dimensions of a block resident in cache.
+template<unsigned int N, typename Scalar, typename Output, typename Buffer, unsigned int MaxDim>
+void sample_halton_sequential(const halton_sampler<MaxDim>& sampler, Buffer buffer, size_t count, std::true_type)
+{
+    radical_inverse_odometer<Scalar> odometer[N];
+    for(unsigned int dim=0; dim<N; ++dim) {
+        odometer[dim].reset(sampler.base[dim], sampler.permutation[dim], sampler.offset);
+        RSM_STATS_ADD_DIMENSION(sampler.base_dim + dim, count);
+    }
+    for(size_t block_begin=0; block_begin<count; block_begin += lds_sequential_block_size) {
+        const size_t block_end = std::min(count, block_begin + lds_sequential_block_size);
+        for(unsigned int dim=0; dim<N; ++dim) {
+            for(size_t i=block_begin; i<block_end; ++i) {
+                Output::store(buffer, i, dim, detail::variate<Scalar>(odometer[dim].value()));
+                odometer[dim].increment();
+            }
+        }
+    }
+}
+
+template<unsigned int N, typename Scalar, typename Output, typename Buffer, unsigned int MaxDim>
+void sample_halton_sequential(const halton_sampler<MaxDim>& sampler, Buffer buffer, size_t count, std::false_type)
+{
+    sample_halton_direct<N, Scalar, Output>(sampler, buffer, count);
+}
+
+template<unsigned int N, typename Scalar, typename Output, typename Buffer, unsigned int MaxDim>
+void sample_halton(const halton_sampler<MaxDim>& sampler, Buffer buffer, size_t count)
+{
+    static_assert(N > 0 && N <= MaxDim, "Requested number of dimensions is not in valid range");
+
+    if(count >= lds_sequential_min_count) {
+        sample_halton_sequential<N, Scalar, Output>(sampler, buffer, count, std::is_floating_point<Scalar>{});
+    }
+    else {
+        sample_halton_direct<N, Scalar, Output>(sampler, buffer, count);
+    }
+    sampler.offset += count;
+}
+
 } // detail
 
 template<typename T, unsigned int MaxDim>
 T sample(const halton_sampler<MaxDim>& sampler)
 {
-    return detail::sample_halton<T>(sampler, 0, sampler.offset++);
+    T v;
+    detail::sample_halton<1, T, detail::interleaved_output<1>>(sampler, &v, 1);
+    return v;
 }
 
 template<unsigned int N, typename T, unsigned int MaxDim>
 T sample_vec(const halton_sampler<MaxDim>& sampler)
 {
-    static_assert(N > 0 && N <= MaxDim, "Requested number of dimensions is not in valid range");
-
     T v;
     using Scalar = typename std::decay<decltype(v[0])>::type;
-    for(unsigned int dim=0; dim<N; ++dim) {
-        v[dim] = detail::sample_halton<Scalar>(sampler, dim, sampler.offset);
-    }
-    ++sampler.offset;
+    detail::sample_halton<N, Scalar, detail::vector_output>(sampler, &v, 1);
     return v;
 }
 
 template<unsigned int N, typename T, unsigned int MaxDim>
 void sample(const halton_sampler<MaxDim>& sampler, T* buffer, size_t count)
 {
-    static_assert(N > 0 && N <= MaxDim, "Requested number of dimensions is not in valid range");
     using Scalar = typename std::decay<decltype(buffer[0])>::type;
-
-    size_t output_index = 0;
-    for(size_t i=0; i<count; ++i) {
-        for(unsigned int dim=0; dim<N; ++dim) {
-            buffer[output_index++] = detail::sample_halton<Scalar>(sampler, dim, sampler.offset);
-        }
-        ++sampler.offset;
-    }
+    detail::sample_halton<N, Scalar, detail::interleaved_output<N>>(sampler, buffer, count);
 }
 
 template<typename T, unsigned int MaxDim>
@@ -98,17 +151,20 @@ void sample(const halton_sampler<MaxDim>& sampler, T* buffer, size_t count)
 template<unsigned int N, typename T, unsigned int MaxDim>
 void sample_vec(const halton_sampler<MaxDim>& sampler, T* buffer, size_t count)
 {
-    static_assert(N > 0 && N <= MaxDim, "Requested number of dimensions is not in valid range");
     using Scalar = typename std::decay<decltype((*buffer)[0])>::type;
+    detail::sample_halton<N, Scalar, detail::vector_output>(sampler, buffer, count);
+}
 
-    size_t output_index = 0;
-    for(size_t i=0; i<count; ++i) {
-        for(unsigned int dim=0; dim<N; ++dim) {
-            buffer[output_index][dim] = detail::sample_halton<Scalar>(sampler, dim, sampler.offset);
-        }
-        ++sampler.offset;
-        ++output_index;
-    }
+template<unsigned int N, typename T, unsigned int MaxDim>
+void sample(const halton_sampler<MaxDim>& sampler, const soa_buffer<T, N>& buffer, size_t count)
+{
+    detail::sample_halton<N, T, detail::soa_output>(sampler, buffer, count);
+}
+
+template<unsigned int N, typename T, unsigned int MaxDim>
+void sample(const halton_sampler<MaxDim>& sampler, const strided_buffer<T>& buffer, size_t count)
+{
+    detail::sample_halton<N, T, detail::strided_output>(sampler, buffer, count);
 }
 
 } // rsm
@@ -0,0 +1,231 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <type_traits>
+
+#include "../detail/common.hpp"
+#include "../detail/output.hpp"
+#include "../lds.hpp"
+#include "../stats.hpp"
+#include "halton.hpp"
+
+#ifndef RSM_HALTON_PIXEL_MAX_RESOLUTION
+#define RSM_HALTON_PIXEL_MAX_RESOLUTION 128
+#endif
+
+namespace rsm {
+
+namespace detail {
+
+inline uint64_t inverse_radical_inverse(uint32_t base, uint64_t inverse, unsigned int num_digits)
+{
+    uint64_t index = 0;
+    for(unsigned int i=0; i<num_digits; ++i) {
+        uint64_t n = inverse / base;
+        index = index * base + (inverse - n * base);
+        inverse = n;
+    }
+    return index;
+}
+
+inline uint64_t multiplicative_inverse(int64_t a, int64_t n)
+{
+    // Extended Euclidean algorithm.
+    int64_t x0 = 1, x1 = 0;
+    int64_t r0 = a, r1 = n;
+    while(r1 != 0) {
+        int64_t q = r0 / r1;
+        int64_t t = r0 - q * r1; r0 = r1; r1 = t;
+        t = x0 - q * x1; x0 = x1; x1 = t;
+    }
+    int64_t m = x0 % n;
+    return static_cast<uint64_t>(m < 0 ? m + n : m);
+}
+
+} // detail
+
+// Halton sampler enumerating samples of the global (image plane) sequence that fall into a given pixel.
+// First two dimensions of the sequence (bases 2 and 3) are scaled to cover a tile of pixels.
+// Indices of samples belonging to a pixel are found using the Chinese remainder theorem so that
+// k-th sample of any pixel is addressable in constant time.
+// See: L. Grünschloß, M. Raab, A. Keller, "Enumerating Quasi-Monte Carlo Point Sequences in Elementary Intervals".
+template<unsigned int MaxDim>
+struct halton_pixel_sampler
+{
+    static_assert(MaxDim >= 2, "Maximum dimension must be at least two");
+
+    halton_pixel_sampler(uint32_t width, uint32_t height, uint32_t x=0, uint32_t y=0)
+        : halton(0)
+        , pixel_offset(0)
+        , offset(0)
+    {
+        assert(width > 0 && height > 0);
+
+        const std::array<uint32_t, 2> resolution = {
+            std::min<uint32_t>(width, RSM_HALTON_PIXEL_MAX_RESOLUTION),
+            std::min<uint32_t>(height, RSM_HALTON_PIXEL_MAX_RESOLUTION),
+        };
+        for(unsigned int i=0; i<2; ++i) {
+            const uint32_t base = halton.base[i];
+            scale[i] = 1;
+            exponent[i] = 0;
+            while(scale[i] < resolution[i]) {
+                scale[i] *= base;
+                ++exponent[i];
+            }
+        }
+        sample_stride = uint64_t(scale[0]) * scale[1];
+        mult_inverse[0] = detail::multiplicative_inverse(scale[1], scale[0]);
+        mult_inverse[1] = detail::multiplicative_inverse(scale[0], scale[1]);
+
+        start_pixel(x, y);
+    }
+
+    void start_pixel(uint32_t x, uint32_t y)
+    {
+        const std::array<uint32_t, 2> p = { x % scale[0], y % scale[1] };
+        pixel_offset = 0;
+        for(unsigned int i=0; i<2; ++i) {
+            uint64_t dim_offset = detail::inverse_radical_inverse(halton.base[i], p[i], exponent[i]);
+            pixel_offset += dim_offset * (sample_stride / scale[i]) * mult_inverse[i];
+        }
+        pixel_offset %= sample_stride;
+        offset = 0;
+    }
+
+    // Index into the global Halton sequence of k-th sample in current pixel.
+    uint64_t sample_index(uint64_t k) const
+    {
+        return pixel_offset + k * sample_stride;
+    }
+
+    halton_sampler<MaxDim> halton;
+    std::array<uint32_t, 2> scale;
+    std::array<unsigned int, 2> exponent;
+    std::array<uint64_t, 2> mult_inverse;
+    uint64_t sample_stride;
+    uint64_t pixel_offset;
+    mutable uint64_t offset;
+};
+
+namespace detail {
+
+// First two dimensions are returned relative to the pixel, i.e. in [0..1) interval within its extent.
+template<typename T, unsigned int MaxDim>
+T sample_halton_pixel(const halton_pixel_sampler<MaxDim>& sampler, unsigned int dim, uint64_t index)
+{
+    assert(dim < MaxDim);
+    switch(dim) {
+    case 0:
+        RSM_STATS_ADD_DIMENSION(0, 1);
+        return detail::variate<T>(radical_inverse<T>(2, index >> sampler.exponent[0]));
+    case 1:
+        RSM_STATS_ADD_DIMENSION(1, 1);
+        return detail::variate<T>(radical_inverse<T>(3, index / sampler.scale[1]));
+    default:
+        return sample_halton<T>(sampler.halton, dim, index);
+    }
+}
+
+template<unsigned int N, typename Scalar, typename Output, typename Buffer, unsigned int MaxDim>
+void sample_halton_pixel_lds(const halton_pixel_sampler<MaxDim>& sampler, Buffer buffer, size_t count, std::true_type)
+{
+    const uint16_t* const* permutation = &sampler.halton.permutation[2];
+    auto kernel = radical_inverse_kernel<Scalar, N-2, Output, 2>::template lookup<Buffer>(2);
+    if(kernel) {
+        for(unsigned int dim=2; dim<N; ++dim) {
+            RSM_STATS_ADD_DIMENSION(dim, count);
+        }
+    }
+    for(size_t i=0; i<count; ++i) {
+        const uint64_t index = sampler.sample_index(sampler.offset + i);
+        if(kernel) {
+            kernel(permutation, index, 1, Output::advance(buffer, i));
+        }
+        else {
+            for(unsigned int dim=2; dim<N; ++dim) {
+                Output::store(buffer, i, dim, sample_halton<Scalar>(sampler.halton, dim, index));
+            }
+        }
+    }
+}
+
+template<unsigned int N, typename Scalar, typename Output, typename Buffer, unsigned int MaxDim>
+void sample_halton_pixel_lds(const halton_pixel_sampler<MaxDim>&, Buffer, size_t, std::false_type)
+{}
+
+template<unsigned int N, typename Scalar, typename Output, typename Buffer, unsigned int MaxDim>
+void sample_halton_pixel(const halton_pixel_sampler<MaxDim>& sampler, Buffer buffer, size_t count)
+{
+    static_assert(N > 0 && N <= MaxDim, "Requested number of dimensions is not in valid range");
+
+    for(size_t i=0; i<count; ++i) {
+        const uint64_t index = sampler.sample_index(sampler.offset + i);
+        for(unsigned int dim=0; dim<N && dim<2; ++dim) {
+            Output::store(buffer, i, dim, sample_halton_pixel<Scalar>(sampler, dim, index));
+        }
+    }
+    sample_halton_pixel_lds<N, Scalar, Output>(sampler, buffer, count, std::integral_constant<bool, (N > 2)>{});
+    sampler.offset += count;
+}
+
+} // detail
+
+template<typename T, unsigned int MaxDim>
+T sample(const halton_pixel_sampler<MaxDim>& sampler)
+{
+    return detail::sample_halton_pixel<T>(sampler, 0, sampler.sample_index(sampler.offset++));
+}
+
+template<unsigned int N, typename T, unsigned int MaxDim>
+T sample_vec(const halton_pixel_sampler<MaxDim>& sampler)
+{
+    T v;
+    using Scalar = typename std::decay<decltype(v[0])>::type;
+    detail::sample_halton_pixel<N, Scalar, detail::vector_output>(sampler, &v, 1);
+    return v;
+}
+
+template<unsigned int N, typename T, unsigned int MaxDim>
+void sample(const halton_pixel_sampler<MaxDim>& sampler, T* buffer, size_t count)
+{
+    using Scalar = typename std::decay<decltype(buffer[0])>::type;
+    detail::sample_halton_pixel<N, Scalar, detail::interleaved_output<N>>(sampler, buffer, count);
+}
+
+template<typename T, unsigned int MaxDim>
+void sample(const halton_pixel_sampler<MaxDim>& sampler, T* buffer, size_t count)
+{
+    sample<1>(sampler, buffer, count);
+}
+
+template<unsigned int N, typename T, unsigned int MaxDim>
+void sample_vec(const halton_pixel_sampler<MaxDim>& sampler, T* buffer, size_t count)
+{
+    using Scalar = typename std::decay<decltype((*buffer)[0])>::type;
+    detail::sample_halton_pixel<N, Scalar, detail::vector_output>(sampler, buffer, count);
+}
+
+template<unsigned int N, typename T, unsigned int MaxDim>
+void sample(const halton_pixel_sampler<MaxDim>& sampler, const soa_buffer<T, N>& buffer, size_t count)
+{
+    detail::sample_halton_pixel<N, T, detail::soa_output>(sampler, buffer, count);
+}
+
+template<unsigned int N, typename T, unsigned int MaxDim>
+void sample(const halton_pixel_sampler<MaxDim>& sampler, const strided_buffer<T>& buffer, size_t count)
+{
+    detail::sample_halton_pixel<N, T, detail::strided_output>(sampler, buffer, count);
+}
+
+} // rsm
@@ -9,11 +9,14 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <algorithm>
 #include <array>
 #include <type_traits>
 
 #include "../detail/common.hpp"
+#include "../detail/output.hpp"
 #include "../lds.hpp"
+#include "../stats.hpp"
 
 namespace rsm {
 
@@ -23,7 +26,8 @@ struct hammersley_sampler
     static_assert(MaxDim > 0, "Maximum dimension must be greater than zero");
 
     explicit hammersley_sampler(size_t max_samples, unsigned int dim=0, uint64_t offset=0)
-        : base_dim(dim)
+        : num_samples(max_samples)
+        , base_dim(dim)
         , offset(offset)
     {
         assert(max_samples > 0);
@@ -41,9 +45,10 @@ struct hammersley_sampler
 
     size_t max_samples() const
     {
-        return static_cast<size_t>(FloatType(1.0) / inv_max_samples);
+        return num_samples;
     }
 
+    size_t num_samples;
     FloatType inv_max_samples;
     std::array<uint32_t, MaxDim-1> base;
     std::array<const uint16_t*, MaxDim-1> permutation;
@@ -53,84 +58,165 @@ struct hammersley_sampler
 
 namespace detail {
 
-template<typename T, unsigned int MaxDim>
-T sample_hammersley(const hammersley_sampler<MaxDim>& sampler, unsigned int dim, uint64_t offset)
+template<typename T, unsigned int MaxDim, typename FloatType>
+T sample_hammersley_first(const hammersley_sampler<MaxDim, FloatType>& sampler, uint64_t offset, std::false_type)
+{
+    return detail::variate<T>(offset * T(sampler.inv_max_samples));
+}
+
+// Fixed-point output: floor(2^32 * offset / max_samples).
+template<typename T, unsigned int MaxDim, typename FloatType>
+T sample_hammersley_first(const hammersley_sampler<MaxDim, FloatType>& sampler, uint64_t offset, std::true_type)
+{
+    static_assert(std::is_same<T, uint32_t>::value, "Fixed-point output is only supported for uint32_t");
+    assert(offset <= 0xffffffffull && sampler.num_samples <= 0x100000000ull);
+    return detail::variate<T>(static_cast<T>(std::min<uint64_t>((offset << 32) / sampler.num_samples, 0xffffffffull)));
+}
+
+template<typename T, unsigned int MaxDim, typename FloatType>
+T sample_hammersley(const hammersley_sampler<MaxDim, FloatType>& sampler, unsigned int dim, uint64_t offset)
 {
     assert(dim < MaxDim);
-    assert(offset * sampler.inv_max_samples <= 1.0);
+    assert(offset <= sampler.num_samples);
 
     if(dim == 0) {
-        return detail::variate<T>(offset * T(sampler.inv_max_samples));
+        return sample_hammersley_first<T>(sampler, offset, std::is_integral<T>{});
     }
     else {
         unsigned int dim_offset = sampler.base_dim + dim - 1;
+        RSM_STATS_ADD_DIMENSION(dim_offset, 1);
         return detail::variate<T>(radical_inverse<T>(dim_offset, sampler.base[dim-1], sampler.permutation[dim-1], offset));
     }
 }
 
-} // detail
+template<unsigned int N, typename Scalar, typename Output, typename Buffer, unsigned int MaxDim, typename FloatType>
+void sample_hammersley_direct(const hammersley_sampler<MaxDim, FloatType>& sampler, Buffer buffer, size_t count)
+{
+    auto kernel = radical_inverse_kernel<Scalar, N-1, Output, 1>::template lookup<Buffer>(sampler.base_dim);
+    if(kernel) {
+        kernel(sampler.permutation.data(), sampler.offset, count, buffer);
+        for(unsigned int dim=1; dim<N; ++dim) {
+            RSM_STATS_ADD_DIMENSION(sampler.base_dim + dim - 1, count);
+        }
+    }
+    else {
+        for(size_t i=0; i<count; ++i) {
+            for(unsigned int dim=1; dim<N; ++dim) {
+                Output::store(buffer, i, dim, sample_hammersley<Scalar>(sampler, dim, sampler.offset + i));
+            }
+        }
+    }
+}
 
-template<typename T, unsigned int MaxDim>
-T sample(const hammersley_sampler<MaxDim>& sampler)
+template<unsigned int N, typename Scalar, typename Output, typename Buffer, unsigned int MaxDim, typename FloatType>
+void sample_hammersley_sequential(const hammersley_sampler<MaxDim, FloatType>& sampler, Buffer buffer, size_t count, std::true_type)
 {
-    return detail::sample_hammersley<T>(sampler, 0, sampler.offset++);
+    radical_inverse_odometer<Scalar> odometer[N-1];
+    for(unsigned int dim=1; dim<N; ++dim) {
+        odometer[dim-1].reset(sampler.base[dim-1], sampler.permutation[dim-1], sampler.offset);
+        RSM_STATS_ADD_DIMENSION(sampler.base_dim + dim - 1, count);
+    }
+    for(size_t block_begin=0; block_begin<count; block_begin += lds_sequential_block_size) {
+        const size_t block_end = std::min(count, block_begin + lds_sequential_block_size);
+        for(unsigned int dim=1; dim<N; ++dim) {
+            for(size_t i=block_begin; i<block_end; ++i) {
+                Output::store(buffer, i, dim, detail::variate<Scalar>(odometer[dim-1].value()));
+                odometer[dim-1].increment();
+            }
+        }
+    }
+}
+
+template<unsigned int N, typename Scalar, typename Output, typename Buffer, unsigned int MaxDim, typename FloatType>
+void sample_hammersley_sequential(const hammersley_sampler<MaxDim, FloatType>& sampler, Buffer buffer, size_t count, std::false_type)
+{
+    sample_hammersley_direct<N, Scalar, Output>(sampler, buffer, count);
+}
+
+template<unsigned int N, typename Scalar, typename Output, typename Buffer, unsigned int MaxDim, typename FloatType>
+void sample_hammersley_lds(const hammersley_sampler<MaxDim, FloatType>& sampler, Buffer buffer, size_t count, std::true_type)
+{
+    if(count >= lds_sequential_min_count) {
+        sample_hammersley_sequential<N, Scalar, Output>(sampler, buffer, count, std::is_floating_point<Scalar>{});
+    }
+    else {
+        sample_hammersley_direct<N, Scalar, Output>(sampler, buffer, count);
+    }
 }
 
-template<unsigned int N, typename T, unsigned int MaxDim>
-T sample_vec(const hammersley_sampler<MaxDim>& sampler)
+template<unsigned int N, typename Scalar, typename Output, typename Buffer, unsigned int MaxDim, typename FloatType>
+void sample_hammersley_lds(const hammersley_sampler<MaxDim, FloatType>&, Buffer, size_t, std::false_type)
+{}
+
+template<unsigned int N, typename Scalar, typename Output, typename Buffer, unsigned int MaxDim, typename FloatType>
+void sample_hammersley(const hammersley_sampler<MaxDim, FloatType>& sampler, Buffer buffer, size_t count)
 {
     static_assert(N > 0 && N <= MaxDim, "Requested number of dimensions is not in valid range");
 
+    for(size_t i=0; i<count; ++i) {
+        Output::store(buffer, i, 0, sample_hammersley_first<Scalar>(sampler, sampler.offset + i, std::is_integral<Scalar>{}));
+    }
+    sample_hammersley_lds<N, Scalar, Output>(sampler, buffer, count, std::integral_constant<bool, (N > 1)>{});
+    sampler.offset += count;
+}
+
+} // detail
+
+template<typename T, unsigned int MaxDim, typename FloatType>
+T sample(const hammersley_sampler<MaxDim, FloatType>& sampler)
+{
+    T v;
+    detail::sample_hammersley<1, T, detail::interleaved_output<1>>(sampler, &v, 1);
+    return v;
+}
+
+template<unsigned int N, typename T, unsigned int MaxDim, typename FloatType>
+T sample_vec(const hammersley_sampler<MaxDim, FloatType>& sampler)
+{
     T v;
     using Scalar = typename std::decay<decltype(v[0])>::type;
-    for(unsigned int dim=0; dim<N; ++dim) {
-        v[dim] = detail::sample_hammersley<Scalar>(sampler, dim, sampler.offset);
-    }
-    ++sampler.offset;
+    detail::sample_hammersley<N, Scalar, detail::vector_output>(sampler, &v, 1);
     return v;
 }
 
-template<unsigned int N, typename T, unsigned int MaxDim>
-void sample(const hammersley_sampler<MaxDim>& sampler, T* buffer, size_t count=0)
+template<unsigned int N, typename T, unsigned int MaxDim, typename FloatType>
+void sample(const hammersley_sampler<MaxDim, FloatType>& sampler, T* buffer, size_t count=0)
 {
-    static_assert(N > 0 && N <= MaxDim, "Requested number of dimensions is not in valid range");
     using Scalar = typename std::decay<decltype(buffer[0])>::type;
-
     size_t requested_samples = (count > 0) ? count : sampler.max_samples();
     assert(sampler.offset + requested_samples <= sampler.max_samples());
-
-    size_t output_index = 0;
-    for(size_t i=0; i<requested_samples; ++i) {
-        for(unsigned int dim=0; dim<N; ++dim) {
-            buffer[output_index++] = detail::sample_hammersley<Scalar>(sampler, dim, sampler.offset);
-        }
-        ++sampler.offset;
-    }
+    detail::sample_hammersley<N, Scalar, detail::interleaved_output<N>>(sampler, buffer, requested_samples);
 }
 
-template<typename T, unsigned int MaxDim>
-void sample(const hammersley_sampler<MaxDim>& sampler, T* buffer, size_t count=0)
+template<typename T, unsigned int MaxDim, typename FloatType>
+void sample(const hammersley_sampler<MaxDim, FloatType>& sampler, T* buffer, size_t count=0)
 {
     sample<1>(sampler, buffer, count);
 }
 
-template<unsigned int N, typename T, unsigned int MaxDim>
-void sample_vec(const hammersley_sampler<MaxDim>& sampler, T* buffer, size_t count=0)
+template<unsigned int N, typename T, unsigned int MaxDim, typename FloatType>
+void sample_vec(const hammersley_sampler<MaxDim, FloatType>& sampler, T* buffer, size_t count=0)
 {
-    static_assert(N > 0 && N <= MaxDim, "Requested number of dimensions is not in valid range");
     using Scalar = typename std::decay<decltype((*buffer)[0])>::type;
+    size_t requested_samples = (count > 0) ? count : sampler.max_samples();
+    assert(sampler.offset + requested_samples <= sampler.max_samples());
+    detail::sample_hammersley<N, Scalar, detail::vector_output>(sampler, buffer, requested_samples);
+}
 
+template<unsigned int N, typename T, unsigned int MaxDim, typename FloatType>
+void sample(const hammersley_sampler<MaxDim, FloatType>& sampler, const soa_buffer<T, N>& buffer, size_t count=0)
+{
     size_t requested_samples = (count > 0) ? count : sampler.max_samples();
     assert(sampler.offset + requested_samples <= sampler.max_samples());
+    detail::sample_hammersley<N, T, detail::soa_output>(sampler, buffer, requested_samples);
+}
 
-    size_t output_index = 0;
-    for(size_t i=0; i<requested_samples; ++i) {
-        for(unsigned int dim=0; dim<N; ++dim) {
-            buffer[output_index][dim] = detail::sample_hammersley<Scalar>(sampler, dim, sampler.offset);
-        }
-        ++sampler.offset;
-        ++output_index;
-    }
+template<unsigned int N, typename T, unsigned int MaxDim, typename FloatType>
+void sample(const hammersley_sampler<MaxDim, FloatType>& sampler, const strided_buffer<T>& buffer, size_t count=0)
+{
+    size_t requested_samples = (count > 0) ? count : sampler.max_samples();
+    assert(sampler.offset + requested_samples <= sampler.max_samples());
+    detail::sample_hammersley<N, T, detail::strided_output>(sampler, buffer, requested_samples);
 }
 
 } // rsm
@@ -0,0 +1,292 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <type_traits>
+
+#include "../detail/common.hpp"
+#include "../detail/memory.hpp"
+#include "../detail/output.hpp"
+#include "../next.hpp"
+
+namespace rsm {
+
+namespace detail {
+
+struct lattice_vector_t
+{
+    uint32_t num_points;
+    uint32_t g[16];
+};
+
+// Generated with lattice_cbc() using default weights.
+constexpr lattice_vector_t lattice_vectors[] = {
+    { 1024,  { 1, 283, 157, 385, 401, 419, 329, 495, 363, 335, 191, 115, 489, 99, 477, 431 } },
+    { 4096,  { 1, 1731, 985, 1869, 1467, 1305, 1683, 1043, 535, 193, 1257, 919, 1991, 339, 615, 103 } },
+    { 16384, { 1, 6229, 2691, 4955, 1105, 4335, 465, 1435, 1003, 4049, 1185, 5245, 3565, 5479, 4497, 6453 } },
+    { 65536, { 1, 25015, 11675, 7425, 10297, 6975, 15043, 12807, 29409, 7675, 20091, 1727, 25951, 13211, 18691, 19857 } },
+};
+
+constexpr unsigned int lattice_vector_max_dim = 16;
+
+inline const uint32_t* lattice_vector(uint32_t num_points)
+{
+    for(const auto& v : lattice_vectors) {
+        if(v.num_points == num_points) {
+            return v.g;
+        }
+    }
+    return nullptr;
+}
+
+inline uint32_t gcd(uint32_t a, uint32_t b)
+{
+    while(b != 0) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+} // detail
+
+// Component-by-component construction of a rank-1 lattice generating vector minimizing the P2 criterion
+// (worst case error in weighted Korobov space with smoothness 2) using product weights.
+// Default weights are 1/j^2 for j-th dimension (counting from 1).
+// Runs in O(dims * n^2) time and O(n) memory so it's intended for offline use with moderate n.
+inline bool lattice_cbc(uint32_t num_points, unsigned int dims, uint32_t* generating_vector,
+                        const double* weights=nullptr, const allocator_t& allocator=detail::default_allocator())
+{
+    assert(num_points > 1 && dims > 0);
+
+    double* omega = detail::alloc<double>(allocator, num_points);
+    if(!omega) {
+        return false;
+    }
+    double* product = detail::alloc<double>(allocator, num_points);
+    if(!product) {
+        detail::free(allocator, omega);
+        return false;
+    }
+
+    // Bernoulli polynomial based kernel: 2pi^2 * B2(x).
+    const double inv_n = 1.0 / num_points;
+    for(uint32_t k=0; k<num_points; ++k) {
+        const double x = k * inv_n;
+        omega[k] = 2.0 * detail::pi<double>() * detail::pi<double>() * (x * x - x + 1.0 / 6.0);
+        product[k] = 1.0;
+    }
+
+    for(unsigned int dim=0; dim<dims; ++dim) {
+        const double weight = weights ? weights[dim] : 1.0 / ((dim + 1.0) * (dim + 1.0));
+
+        uint32_t best_z = 1;
+        if(dim > 0) {
+            // Error is symmetric in z and n-z, so only half of the candidates need to be tested.
+            double best_error = 0.0;
+            for(uint32_t z=1; z<=num_points/2; ++z) {
+                if(detail::gcd(z, num_points) != 1) {
+                    continue;
+                }
+                double error = 0.0;
+                for(uint32_t i=0, k=0; i<num_points; ++i) {
+                    error += product[i] * omega[k];
+                    k += z;
+                    k = (k >= num_points) ? k - num_points : k;
+                }
+                if(best_z == 1 || error < best_error) {
+                    best_z = z;
+                    best_error = error;
+                }
+            }
+        }
+        generating_vector[dim] = best_z;
+
+        for(uint32_t i=0, k=0; i<num_points; ++i) {
+            product[i] *= 1.0 + weight * omega[k];
+            k += best_z;
+            k = (k >= num_points) ? k - num_points : k;
+        }
+    }
+
+    detail::free(allocator, omega);
+    detail::free(allocator, product);
+    return true;
+}
+
+template<unsigned int MaxDim>
+std::array<uint32_t, MaxDim> korobov_vector(uint32_t num_points, uint32_t a)
+{
+    assert(num_points > 0);
+    std::array<uint32_t, MaxDim> g;
+    uint64_t value = 1;
+    for(unsigned int i=0; i<MaxDim; ++i) {
+        g[i] = static_cast<uint32_t>(value);
+        value = (value * a) % num_points;
+    }
+    return g;
+}
+
+// Rank-1 lattice: x_i = frac(i * g / n + shift).
+// Shift is zero unless randomized by calling rotate() (Cranley-Patterson rotation).
+template<unsigned int MaxDim, typename FloatType=double>
+struct lattice_sampler
+{
+    static_assert(MaxDim > 0, "Maximum dimension must be greater than zero");
+
+    // Uses one of the precomputed generating vectors (available for 2^10, 2^12, 2^14 and 2^16 points, up to 16 dimensions).
+    // For other point counts and dimensions generating vector is computed with lattice_cbc() in O(MaxDim * n^2) time;
+    // if its temporary storage can't be allocated all components of generating vector are 1.
+    static lattice_sampler precomputed(uint32_t num_points, uint64_t offset=0,
+                                       const allocator_t& allocator=detail::default_allocator())
+    {
+        const uint32_t* table = (MaxDim <= detail::lattice_vector_max_dim) ? detail::lattice_vector(num_points) : nullptr;
+        if(table) {
+            return lattice_sampler(num_points, table, offset);
+        }
+        std::array<uint32_t, MaxDim> generating_vector;
+        if(num_points < 2 || !lattice_cbc(num_points, MaxDim, generating_vector.data(), nullptr, allocator)) {
+            generating_vector.fill(1);
+        }
+        return lattice_sampler(num_points, generating_vector, offset);
+    }
+
+    lattice_sampler(uint32_t num_points, const std::array<uint32_t, MaxDim>& generating_vector, uint64_t offset=0)
+        : lattice_sampler(num_points, generating_vector.data(), offset)
+    {}
+
+    // Catches lattice_sampler(n, 0) which would otherwise pass 0 as a null generating vector; use precomputed(n, 0).
+    lattice_sampler(uint32_t num_points, int, uint64_t offset=0) = delete;
+
+    lattice_sampler(uint32_t num_points, const uint32_t* generating_vector, uint64_t offset=0)
+        : num_points(num_points)
+        , offset(offset)
+    {
+        assert(num_points > 0);
+        assert(generating_vector);
+        inv_num_points = FloatType(1.0) / num_points;
+        for(unsigned int i=0; i<MaxDim; ++i) {
+            generator[i] = generating_vector[i] % num_points;
+        }
+        shift.fill(FloatType(0.0));
+    }
+
+    template<typename Generator>
+    void rotate(Generator& g)
+    {
+        for(unsigned int i=0; i<MaxDim; ++i) {
+            shift[i] = next<FloatType>(g);
+        }
+    }
+
+    size_t max_samples() const
+    {
+        return num_points;
+    }
+
+    uint32_t num_points;
+    FloatType inv_num_points;
+    std::array<uint32_t, MaxDim> generator;
+    std::array<FloatType, MaxDim> shift;
+    mutable uint64_t offset;
+};
+
+namespace detail {
+
+template<typename T, unsigned int MaxDim, typename FloatType>
+T sample_lattice(const lattice_sampler<MaxDim, FloatType>& sampler, unsigned int dim, uint64_t offset)
+{
+    assert(dim < MaxDim);
+    const uint64_t k = ((offset % sampler.num_points) * sampler.generator[dim]) % sampler.num_points;
+    T x = T(k * sampler.inv_num_points + sampler.shift[dim]);
+    x = (x >= T(1.0)) ? x - T(1.0) : x;
+    return detail::variate<T>(x);
+}
+
+template<unsigned int N, typename Scalar, typename Output, typename Buffer, unsigned int MaxDim, typename FloatType>
+void sample_lattice(const lattice_sampler<MaxDim, FloatType>& sampler, Buffer buffer, size_t count)
+{
+    static_assert(N > 0 && N <= MaxDim, "Requested number of dimensions is not in valid range");
+
+    // Lattice indices are advanced incrementally (k += g mod n) to avoid divisions in the inner loop.
+    const uint32_t n = sampler.num_points;
+    uint32_t k[N];
+    for(unsigned int dim=0; dim<N; ++dim) {
+        k[dim] = static_cast<uint32_t>(((sampler.offset % n) * sampler.generator[dim]) % n);
+    }
+    for(size_t i=0; i<count; ++i) {
+        for(unsigned int dim=0; dim<N; ++dim) {
+            Scalar x = Scalar(k[dim] * sampler.inv_num_points + sampler.shift[dim]);
+            x = (x >= Scalar(1.0)) ? x - Scalar(1.0) : x;
+            Output::store(buffer, i, dim, detail::variate<Scalar>(x));
+
+            const uint32_t next_k = k[dim] + sampler.generator[dim];
+            k[dim] = (next_k >= n || next_k < k[dim]) ? next_k - n : next_k;
+        }
+    }
+    sampler.offset += count;
+}
+
+} // detail
+
+template<typename T, unsigned int MaxDim, typename FloatType>
+T sample(const lattice_sampler<MaxDim, FloatType>& sampler)
+{
+    return detail::sample_lattice<T>(sampler, 0, sampler.offset++);
+}
+
+template<unsigned int N, typename T, unsigned int MaxDim, typename FloatType>
+T sample_vec(const lattice_sampler<MaxDim, FloatType>& sampler)
+{
+    T v;
+    using Scalar = typename std::decay<decltype(v[0])>::type;
+    detail::sample_lattice<N, Scalar, detail::vector_output>(sampler, &v, 1);
+    return v;
+}
+
+template<unsigned int N, typename T, unsigned int MaxDim, typename FloatType>
+void sample(const lattice_sampler<MaxDim, FloatType>& sampler, T* buffer, size_t count=0)
+{
+    using Scalar = typename std::decay<decltype(buffer[0])>::type;
+    size_t requested_samples = (count > 0) ? count : sampler.max_samples();
+    detail::sample_lattice<N, Scalar, detail::interleaved_output<N>>(sampler, buffer, requested_samples);
+}
+
+template<typename T, unsigned int MaxDim, typename FloatType>
+void sample(const lattice_sampler<MaxDim, FloatType>& sampler, T* buffer, size_t count=0)
+{
+    sample<1>(sampler, buffer, count);
+}
+
+template<unsigned int N, typename T, unsigned int MaxDim, typename FloatType>
+void sample_vec(const lattice_sampler<MaxDim, FloatType>& sampler, T* buffer, size_t count=0)
+{
+    using Scalar = typename std::decay<decltype((*buffer)[0])>::type;
+    size_t requested_samples = (count > 0) ? count : sampler.max_samples();
+    detail::sample_lattice<N, Scalar, detail::vector_output>(sampler, buffer, requested_samples);
+}
+
+template<unsigned int N, typename T, unsigned int MaxDim, typename FloatType>
+void sample(const lattice_sampler<MaxDim, FloatType>& sampler, const soa_buffer<T, N>& buffer, size_t count=0)
+{
+    size_t requested_samples = (count > 0) ? count : sampler.max_samples();
+    detail::sample_lattice<N, T, detail::soa_output>(sampler, buffer, requested_samples);
+}
+
+template<unsigned int N, typename T, unsigned int MaxDim, typename FloatType>
+void sample(const lattice_sampler<MaxDim, FloatType>& sampler, const strided_buffer<T>& buffer, size_t count=0)
+{
+    size_t requested_samples = (count > 0) ? count : sampler.max_samples();
+    detail::sample_lattice<N, T, detail::strided_output>(sampler, buffer, requested_samples);
+}
+
+} // rsm
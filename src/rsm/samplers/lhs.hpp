@@ -8,12 +8,12 @@
 
 #include <cstddef>
 #include <cstdint>
-#include <utility>
 #include <type_traits>
 
+#include "../detail/common.hpp"
+#include "../detail/output.hpp"
 #include "../next.hpp"
 #include "../options.hpp"
-#include "../utils.hpp"
 
 namespace rsm {
 
@@ -25,34 +25,50 @@ struct lhs_sampler
     options_t options;
 };
 
-template<unsigned int N, typename T, typename Generator>
-void sample(const lhs_sampler& sampler, Generator& generator, T* buffer, size_t count)
+namespace detail {
+
+// Every dimension is stratified into count intervals which are then independently shuffled.
+template<unsigned int N, typename Scalar, typename Output, typename Buffer, typename Generator>
+void sample_lhs(const lhs_sampler& sampler, Generator& generator, Buffer buffer, size_t count)
 {
     static_assert(N > 0, "Requested number of dimensions is not in valid range");
-    using Scalar = typename std::decay<decltype(buffer[0])>::type;
 
     if(count == 0) {
         return;
     }
 
-    size_t output_index = 0;
     Scalar delta = Scalar(1.0) / count;
     if(sampler.options & opt::jitter) {
         for(size_t i=0; i<count; ++i) {
             for(unsigned int dim=0; dim<N; ++dim) {
-                Scalar jitter = next<Scalar>(generator);
-                buffer[output_index++] = detail::variate<Scalar>((i + jitter) * delta);
+                Scalar jitter = rsm::next<Scalar>(generator);
+                Output::store(buffer, i, dim, detail::variate<Scalar>((i + jitter) * delta));
             }
         }
     }
     else {
         for(size_t i=0; i<count; ++i) {
             for(unsigned int dim=0; dim<N; ++dim) {
-                buffer[output_index++] = detail::variate<Scalar>((i + Scalar(0.5)) * delta);
+                Output::store(buffer, i, dim, detail::variate<Scalar>((i + Scalar(0.5)) * delta));
             }
         }
     }
-    shuffle_inner<N>(generator, &buffer[0], &buffer[N * count]);
+    const uint32_t n = static_cast<uint32_t>(count);
+    for(unsigned int dim=0; dim<N; ++dim) {
+        for(uint32_t i=0; i<n; ++i) {
+            uint32_t r = rsm::next(generator, i, n);
+            Output::swap(buffer, i, r, dim);
+        }
+    }
+}
+
+} // detail
+
+template<unsigned int N, typename T, typename Generator>
+void sample(const lhs_sampler& sampler, Generator& generator, T* buffer, size_t count)
+{
+    using Scalar = typename std::decay<decltype(buffer[0])>::type;
+    detail::sample_lhs<N, Scalar, detail::interleaved_output<N>>(sampler, generator, buffer, count);
 }
 
 template<typename T, typename Generator>
@@ -64,35 +80,20 @@ void sample(const lhs_sampler& sampler, Generator& generator, T* buffer, size_t
 template<unsigned int N, typename T, typename Generator>
 void sample_vec(const lhs_sampler& sampler, Generator& generator, T* buffer, size_t count)
 {
-    static_assert(N > 0, "Requested number of dimensions is not in valid range");
     using Scalar = typename std::decay<decltype((*buffer)[0])>::type;
+    detail::sample_lhs<N, Scalar, detail::vector_output>(sampler, generator, buffer, count);
+}
 
-    if(count == 0) {
-        return;
-    }
+template<unsigned int N, typename T, typename Generator>
+void sample(const lhs_sampler& sampler, Generator& generator, const soa_buffer<T, N>& buffer, size_t count)
+{
+    detail::sample_lhs<N, T, detail::soa_output>(sampler, generator, buffer, count);
+}
 
-    Scalar delta = Scalar(1.0) / count;
-    if(sampler.options & opt::jitter) {
-        for(size_t i=0; i<count; ++i) {
-            for(unsigned int dim=0; dim<N; ++dim) {
-                Scalar jitter = next<Scalar>(generator);
-                buffer[i][dim] = detail::variate<Scalar>((i + jitter) * delta);
-            }
-        }
-    }
-    else {
-        for(size_t i=0; i<count; ++i) {
-            for(unsigned int dim=0; dim<N; ++dim) {
-                buffer[i][dim] = detail::variate<Scalar>((i + Scalar(0.5)) * delta);
-            }
-        }
-    }
-    for(unsigned int dim=0; dim<N; ++dim) {
-        for(size_t i=0; i<count; ++i) {
-            uint32_t r = next(generator, i, count);
-            std::swap(buffer[i][dim], buffer[r][dim]);
-        }
-    }
+template<unsigned int N, typename T, typename Generator>
+void sample(const lhs_sampler& sampler, Generator& generator, const strided_buffer<T>& buffer, size_t count)
+{
+    detail::sample_lhs<N, T, detail::strided_output>(sampler, generator, buffer, count);
 }
 
 } // rsm
@@ -0,0 +1,164 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+#include "../detail/common.hpp"
+#include "../detail/hash.hpp"
+#include "../detail/primes.hpp"
+#include "../detail/ldsperm.hpp"
+#include "../lds.hpp"
+#include "../stats.hpp"
+
+namespace rsm {
+
+namespace pad {
+
+enum padding_mode {
+    random  = 0,
+    lattice = 1,
+};
+
+} // pad
+
+struct dimension_block
+{
+    unsigned int first;
+    unsigned int count;
+    bool per_vertex;
+};
+
+// Hands out blocks of sequence dimensions so that every decision of a path consumes its own dimensions.
+// Per-path blocks (e.g. pixel position, lens, time) are laid out first, followed by per-vertex blocks
+// (e.g. BSDF, light, roulette) repeated for every path vertex. Allocate all blocks before sampling.
+class dimension_layout
+{
+public:
+    explicit dimension_layout(unsigned int first_dim=0)
+        : m_first_dim(first_dim)
+        , m_path_dims(0)
+        , m_vertex_dims(0)
+    {}
+
+    dimension_block allocate(unsigned int count)
+    {
+        assert(count > 0);
+        dimension_block block = { m_path_dims, count, false };
+        m_path_dims += count;
+        return block;
+    }
+
+    dimension_block allocate_vertex(unsigned int count)
+    {
+        assert(count > 0);
+        dimension_block block = { m_vertex_dims, count, true };
+        m_vertex_dims += count;
+        return block;
+    }
+
+    // Global sequence dimension of dim-th dimension of a block at given path vertex.
+    unsigned int dimension(const dimension_block& block, unsigned int dim, unsigned int vertex=0) const
+    {
+        assert(dim < block.count);
+        if(block.per_vertex) {
+            return m_first_dim + m_path_dims + vertex * m_vertex_dims + block.first + dim;
+        }
+        return m_first_dim + block.first + dim;
+    }
+
+    // Total number of dimensions consumed by a path with given number of vertices.
+    unsigned int num_dimensions(unsigned int num_vertices) const
+    {
+        return m_first_dim + m_path_dims + num_vertices * m_vertex_dims;
+    }
+
+private:
+    unsigned int m_first_dim;
+    unsigned int m_path_dims;
+    unsigned int m_vertex_dims;
+};
+
+// Stateless sampler returning a value for any (pixel, sample, dimension) triple.
+// Dimensions within the QMC budget (primes_t::N by default) come from the scrambled Halton sequence
+// randomized per pixel by a hashed Cranley-Patterson rotation. Dimensions beyond the budget are padded
+// either with independent hashed random numbers or with a randomly rotated rank-1 lattice over 2^32 points
+// whose odd generator is hashed per dimension; neither reuses any QMC dimension.
+template<typename FloatType=double>
+struct padded_sampler
+{
+    explicit padded_sampler(uint64_t seed=0, pad::padding_mode padding=pad::random, unsigned int qmc_dims=0)
+        : seed(seed)
+        , padding(padding)
+    {
+        const auto& g_primes = detail::primes_t::get();
+        assert(g_primes.N > 0);
+        num_qmc_dims = (qmc_dims > 0) ? std::min<unsigned int>(qmc_dims, g_primes.N) : g_primes.N;
+    }
+
+    uint64_t seed;
+    pad::padding_mode padding;
+    unsigned int num_qmc_dims;
+};
+
+namespace detail {
+
+template<typename T>
+T rotate_variate(T x, T shift)
+{
+    x += shift;
+    x = (x >= T(1)) ? x - T(1) : x;
+    return variate<T>(x);
+}
+
+} // detail
+
+template<typename T, typename FloatType>
+T sample(const padded_sampler<FloatType>& sampler, uint64_t pixel, uint64_t sample_index, unsigned int dim)
+{
+    const uint64_t pixel_key = detail::hash(sampler.seed, pixel);
+    if(dim < sampler.num_qmc_dims) {
+        const auto& g_primes = detail::primes_t::get();
+        const auto& g_permutations = detail::lds_permutations_t::get();
+        RSM_STATS_ADD_DIMENSION(dim, 1);
+        const T x = radical_inverse<T>(dim, uint16_t(g_primes.p[dim]), &g_permutations.p[g_primes.sum[dim]], sample_index);
+        return detail::rotate_variate(x, detail::hash_variate<T>(detail::hash(pixel_key, dim)));
+    }
+    if(sampler.padding == pad::lattice) {
+        const uint32_t generator = static_cast<uint32_t>(detail::hash(sampler.seed, dim)) | 1u;
+        const uint32_t k = static_cast<uint32_t>(sample_index) * generator;
+        const T x = T(k * FloatType(1.0 / 4294967296.0));
+        return detail::rotate_variate(x, detail::hash_variate<T>(detail::hash(pixel_key, dim)));
+    }
+    return detail::hash_variate<T>(detail::hash(pixel_key, sample_index, dim));
+}
+
+template<typename T, typename FloatType>
+T sample(const padded_sampler<FloatType>& sampler, const dimension_layout& layout, const dimension_block& block,
+         uint64_t pixel, uint64_t sample_index, unsigned int dim, unsigned int vertex=0)
+{
+    return sample<T>(sampler, pixel, sample_index, layout.dimension(block, dim, vertex));
+}
+
+template<unsigned int N, typename T, typename FloatType>
+T sample_vec(const padded_sampler<FloatType>& sampler, const dimension_layout& layout, const dimension_block& block,
+             uint64_t pixel, uint64_t sample_index, unsigned int vertex=0)
+{
+    assert(N <= block.count);
+    T v;
+    using Scalar = typename std::decay<decltype(v[0])>::type;
+    for(unsigned int dim=0; dim<N; ++dim) {
+        v[dim] = sample<Scalar>(sampler, pixel, sample_index, layout.dimension(block, dim, vertex));
+    }
+    return v;
+}
+
+} // rsm
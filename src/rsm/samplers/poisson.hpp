@@ -0,0 +1,445 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+
+#include "../detail/common.hpp"
+#include "../detail/hash.hpp"
+#include "../detail/memory.hpp"
+#include "../detail/output.hpp"
+#include "../executor.hpp"
+#include "../next.hpp"
+
+namespace rsm {
+
+// Poisson disk point set in [0..1)^N with no two points closer than radius, generated with Bridson's algorithm.
+// Points are kept in a background grid with cells small enough to hold at most one point each, so the number
+// of generated points is never greater than max_samples().
+// See: R. Bridson, "Fast Poisson Disk Sampling in Arbitrary Dimensions".
+template<unsigned int N>
+struct poisson_disk_sampler
+{
+    static_assert(N == 2 || N == 3, "Poisson disk sampling is only supported in 2 and 3 dimensions");
+
+    explicit poisson_disk_sampler(double radius, uint32_t max_attempts=30, uint32_t tile_size=32)
+        : radius(radius)
+        , max_attempts(max_attempts)
+        , tile_size(tile_size)
+    {
+        assert(radius > 0.0 && radius < 1.0);
+        assert(max_attempts > 0);
+        grid_size = static_cast<uint32_t>(std::ceil(std::sqrt(double(N)) / radius));
+    }
+
+    size_t max_samples() const
+    {
+        size_t count = grid_size;
+        for(unsigned int dim=1; dim<N; ++dim) {
+            count *= grid_size;
+        }
+        return count;
+    }
+
+    double radius;
+    uint32_t max_attempts;
+    // Size of a parallel tile in grid cells.
+    uint32_t tile_size;
+    uint32_t grid_size;
+};
+
+namespace detail {
+
+template<unsigned int N, typename Scalar>
+struct poisson_disk_grid
+{
+    // N coordinates per cell; empty cells hold a point at (-2, ..., -2), farther than radius from any point in [0..1)^N.
+    Scalar* points;
+    uint32_t size;
+    Scalar inv_cell_size;
+    Scalar radius;
+    uint32_t max_attempts;
+    // Points closer than radius are at most this many cells apart along every axis.
+    uint32_t search_extent;
+
+    size_t cell_index(const uint32_t* cell) const
+    {
+        size_t index = cell[N-1];
+        for(unsigned int dim=N-1; dim>0; --dim) {
+            index = index * size + cell[dim-1];
+        }
+        return index;
+    }
+
+    const Scalar* point(const uint32_t* cell) const
+    {
+        const Scalar* p = points + N * cell_index(cell);
+        return (p[0] >= Scalar(0.0)) ? p : nullptr;
+    }
+};
+
+// Calls f(cell) for every cell of box [lo, hi) until f returns false.
+template<unsigned int N, typename F>
+void poisson_disk_for_each_cell(const uint32_t* lo, const uint32_t* hi, F&& f)
+{
+    for(unsigned int dim=0; dim<N; ++dim) {
+        if(lo[dim] >= hi[dim]) {
+            return;
+        }
+    }
+    uint32_t cell[N];
+    std::copy(lo, lo + N, cell);
+    for(;;) {
+        if(!f(static_cast<const uint32_t*>(cell))) {
+            return;
+        }
+        unsigned int dim = 0;
+        for(; dim<N && ++cell[dim] == hi[dim]; ++dim) {
+            cell[dim] = lo[dim];
+        }
+        if(dim == N) {
+            return;
+        }
+    }
+}
+
+// Uniformly distributed point in a spherical shell [radius, 2*radius) around center.
+template<typename Scalar, typename Generator>
+void poisson_disk_candidate(const Scalar* center, Scalar radius, Generator& generator, Scalar* p, std::integral_constant<unsigned int, 2>)
+{
+    const Scalar r = radius * std::sqrt(Scalar(1.0) + Scalar(3.0) * rsm::next<Scalar>(generator));
+    const Scalar phi = Scalar(2.0) * pi<Scalar>() * rsm::next<Scalar>(generator);
+    p[0] = center[0] + r * std::cos(phi);
+    p[1] = center[1] + r * std::sin(phi);
+}
+
+template<typename Scalar, typename Generator>
+void poisson_disk_candidate(const Scalar* center, Scalar radius, Generator& generator, Scalar* p, std::integral_constant<unsigned int, 3>)
+{
+    const Scalar r = radius * std::cbrt(Scalar(1.0) + Scalar(7.0) * rsm::next<Scalar>(generator));
+    const Scalar z = Scalar(1.0) - Scalar(2.0) * rsm::next<Scalar>(generator);
+    const Scalar rxy = std::sqrt(std::max(Scalar(0.0), Scalar(1.0) - z * z));
+    const Scalar phi = Scalar(2.0) * pi<Scalar>() * rsm::next<Scalar>(generator);
+    p[0] = center[0] + r * rxy * std::cos(phi);
+    p[1] = center[1] + r * rxy * std::sin(phi);
+    p[2] = center[2] + r * z;
+}
+
+// Tests whether all points in cells of box [lo, hi) are at least radius away from p.
+// Empty cells hold a point far outside of the unit cube so no occupancy test is needed.
+template<typename Scalar>
+bool poisson_disk_scan(const poisson_disk_grid<2, Scalar>& grid, const Scalar* p, const uint32_t* lo, const uint32_t* hi,
+                       std::integral_constant<unsigned int, 2>)
+{
+    const Scalar radius_sqr = grid.radius * grid.radius;
+    for(uint32_t y=lo[1]; y<hi[1]; ++y) {
+        const Scalar* q = grid.points + 2 * (size_t(y) * grid.size + lo[0]);
+        bool conflict = false;
+        for(uint32_t x=lo[0]; x<hi[0]; ++x, q += 2) {
+            const Scalar dx = p[0] - q[0];
+            const Scalar dy = p[1] - q[1];
+            conflict |= (dx * dx + dy * dy < radius_sqr);
+        }
+        if(conflict) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Scalar>
+bool poisson_disk_scan(const poisson_disk_grid<3, Scalar>& grid, const Scalar* p, const uint32_t* lo, const uint32_t* hi,
+                       std::integral_constant<unsigned int, 3>)
+{
+    const Scalar radius_sqr = grid.radius * grid.radius;
+    for(uint32_t z=lo[2]; z<hi[2]; ++z) {
+        for(uint32_t y=lo[1]; y<hi[1]; ++y) {
+            const Scalar* q = grid.points + 3 * ((size_t(z) * grid.size + y) * grid.size + lo[0]);
+            bool conflict = false;
+            for(uint32_t x=lo[0]; x<hi[0]; ++x, q += 3) {
+                const Scalar dx = p[0] - q[0];
+                const Scalar dy = p[1] - q[1];
+                const Scalar dz = p[2] - q[2];
+                conflict |= (dx * dx + dy * dy + dz * dz < radius_sqr);
+            }
+            if(conflict) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Tests whether point p lies within tile [lo, hi) and keeps minimum distance to all points in the grid.
+template<unsigned int N, typename Scalar>
+bool poisson_disk_accept(const poisson_disk_grid<N, Scalar>& grid, const Scalar* p, const uint32_t* lo, const uint32_t* hi, uint32_t* cell)
+{
+    uint32_t search_lo[N];
+    uint32_t search_hi[N];
+    for(unsigned int dim=0; dim<N; ++dim) {
+        if(!(p[dim] >= Scalar(0.0) && p[dim] < Scalar(1.0))) {
+            return false;
+        }
+        cell[dim] = std::min(static_cast<uint32_t>(p[dim] * grid.inv_cell_size), grid.size - 1);
+        if(cell[dim] < lo[dim] || cell[dim] >= hi[dim]) {
+            return false;
+        }
+        search_lo[dim] = (cell[dim] >= grid.search_extent) ? cell[dim] - grid.search_extent : 0;
+        search_hi[dim] = std::min(cell[dim] + grid.search_extent + 1, grid.size);
+    }
+    if(grid.point(cell)) {
+        return false;
+    }
+
+    return poisson_disk_scan(grid, p, search_lo, search_hi, std::integral_constant<unsigned int, N>{});
+}
+
+// Fills tile [lo, hi) of the grid. Candidates are spawned from points already present within ring cells
+// around the tile first so that the tile joins up with its neighbors without violating minimum distance.
+// Only cells within the tile are written and only cells up to max(ring, search extent) cells away from it are read.
+template<unsigned int N, typename Scalar, typename Generator>
+void poisson_disk_tile(const poisson_disk_grid<N, Scalar>& grid, const uint32_t* lo, const uint32_t* hi, uint32_t ring,
+                       uint32_t* active, Generator& generator)
+{
+    using dimension_tag = std::integral_constant<unsigned int, N>;
+
+    size_t num_active = 0;
+    uint32_t cell[N];
+    Scalar p[N];
+    auto insert = [&]() {
+        std::copy(p, p + N, grid.points + N * grid.cell_index(cell));
+        active[num_active++] = static_cast<uint32_t>(grid.cell_index(cell));
+    };
+
+    if(ring > 0) {
+        uint32_t ring_lo[N];
+        uint32_t ring_hi[N];
+        for(unsigned int dim=0; dim<N; ++dim) {
+            ring_lo[dim] = (lo[dim] >= ring) ? lo[dim] - ring : 0;
+            ring_hi[dim] = std::min(hi[dim] + ring, grid.size);
+        }
+        poisson_disk_for_each_cell<N>(ring_lo, ring_hi, [&](const uint32_t* neighbor) {
+            const Scalar* q = grid.point(neighbor);
+            if(!q) {
+                return true;
+            }
+            for(uint32_t attempt=0; attempt<grid.max_attempts; ++attempt) {
+                poisson_disk_candidate(q, grid.radius, generator, p, dimension_tag{});
+                if(poisson_disk_accept(grid, p, lo, hi, cell)) {
+                    insert();
+                }
+            }
+            return true;
+        });
+    }
+    if(num_active == 0) {
+        const Scalar cell_size = Scalar(1.0) / grid.inv_cell_size;
+        for(uint32_t attempt=0; attempt<grid.max_attempts; ++attempt) {
+            for(unsigned int dim=0; dim<N; ++dim) {
+                p[dim] = (lo[dim] + rsm::next<Scalar>(generator) * (hi[dim] - lo[dim])) * cell_size;
+            }
+            if(poisson_disk_accept(grid, p, lo, hi, cell)) {
+                insert();
+                break;
+            }
+        }
+    }
+
+    while(num_active > 0) {
+        const uint32_t i = rsm::next(generator, uint32_t(0), static_cast<uint32_t>(num_active));
+        const Scalar* q = grid.points + N * size_t(active[i]);
+        bool found = false;
+        for(uint32_t attempt=0; attempt<grid.max_attempts && !found; ++attempt) {
+            poisson_disk_candidate(q, grid.radius, generator, p, dimension_tag{});
+            found = poisson_disk_accept(grid, p, lo, hi, cell);
+        }
+        if(found) {
+            insert();
+        }
+        else {
+            active[i] = active[--num_active];
+        }
+    }
+}
+
+// Parallel generation processes tiles in 2^N phases; tiles processed within a single phase have the same
+// coordinate parity so they are separated by at least one whole tile and never touch the same cells.
+// Every tile draws from its own generator seeded by a hash of its index, so the result doesn't depend
+// on the executor or the number of threads.
+template<unsigned int N, typename Scalar, typename Output, typename Buffer, typename Executor, typename Generator>
+size_t sample_poisson_disk(const Executor* executor, const poisson_disk_sampler<N>& sampler, Generator& generator,
+                           Buffer buffer, const allocator_t& allocator)
+{
+    const size_t num_cells = sampler.max_samples();
+    assert(num_cells <= 0xffffffffull);
+
+    // Cell size 1 / grid_size is at most radius / sqrt(N) but generally smaller, so points closer than radius can be
+    // up to ceil(radius * grid_size) cells apart along an axis and candidates are spawned up to twice as far.
+    // Tiles are at least ring cells wide so tiles processed concurrently never read cells written by each other.
+    const uint32_t search_extent = static_cast<uint32_t>(std::ceil(sampler.radius * sampler.grid_size));
+    const uint32_t ring = static_cast<uint32_t>(std::ceil(2.0 * sampler.radius * sampler.grid_size));
+    const uint32_t tile_size = executor ? std::min(std::max(sampler.tile_size, ring), sampler.grid_size) : sampler.grid_size;
+    const uint32_t num_tiles_1d = (sampler.grid_size + tile_size - 1) / tile_size;
+
+    size_t tile_cells = tile_size;
+    size_t num_tiles = num_tiles_1d;
+    for(unsigned int dim=1; dim<N; ++dim) {
+        tile_cells *= tile_size;
+        num_tiles *= num_tiles_1d;
+    }
+
+    poisson_disk_grid<N, Scalar> grid;
+    grid.points = detail::alloc<Scalar>(allocator, N * num_cells);
+    if(!grid.points) {
+        return 0;
+    }
+    uint32_t* active = detail::alloc<uint32_t>(allocator, num_tiles * tile_cells);
+    if(!active) {
+        detail::free(allocator, grid.points);
+        return 0;
+    }
+    grid.size = sampler.grid_size;
+    grid.inv_cell_size = Scalar(sampler.grid_size);
+    grid.radius = Scalar(sampler.radius);
+    grid.max_attempts = sampler.max_attempts;
+    grid.search_extent = search_extent;
+    std::fill(grid.points, grid.points + N * num_cells, Scalar(-2.0));
+
+    auto process_tile = [&](size_t tile, const uint32_t* tile_index, Generator& tile_generator) {
+        uint32_t lo[N];
+        uint32_t hi[N];
+        for(unsigned int dim=0; dim<N; ++dim) {
+            lo[dim] = tile_index[dim] * tile_size;
+            hi[dim] = std::min(lo[dim] + tile_size, sampler.grid_size);
+        }
+        poisson_disk_tile(grid, lo, hi, (num_tiles > 1) ? ring : 0, active + tile * tile_cells, tile_generator);
+    };
+
+    if(executor) {
+        const uint64_t seed = rsm::next<uint64_t>(generator);
+        for(unsigned int phase=0; phase<(1u << N); ++phase) {
+            uint32_t phase_tiles[N];
+            size_t num_phase_tiles = 1;
+            for(unsigned int dim=0; dim<N; ++dim) {
+                const uint32_t parity = (phase >> dim) & 1;
+                phase_tiles[dim] = (num_tiles_1d + 1 - parity) / 2;
+                num_phase_tiles *= phase_tiles[dim];
+            }
+            executor->parallel_for(num_phase_tiles, [&](size_t task) {
+                uint32_t tile_index[N];
+                size_t tile = 0;
+                for(unsigned int dim=0; dim<N; ++dim) {
+                    tile_index[dim] = 2 * static_cast<uint32_t>(task % phase_tiles[dim]) + ((phase >> dim) & 1);
+                    task /= phase_tiles[dim];
+                }
+                for(unsigned int dim=N; dim>0; --dim) {
+                    tile = tile * num_tiles_1d + tile_index[dim-1];
+                }
+                Generator tile_generator(detail::hash(seed, tile));
+                process_tile(tile, tile_index, tile_generator);
+            });
+        }
+    }
+    else {
+        const uint32_t tile_index[N] = {};
+        process_tile(0, tile_index, generator);
+    }
+
+    // Points are written out in grid cell order with the first dimension varying fastest.
+    size_t count = 0;
+    for(size_t i=0; i<num_cells; ++i) {
+        const Scalar* p = grid.points + N * i;
+        if(p[0] >= Scalar(0.0)) {
+            for(unsigned int dim=0; dim<N; ++dim) {
+                Output::store(buffer, count, dim, p[dim]);
+            }
+            ++count;
+        }
+    }
+
+    detail::free(allocator, grid.points);
+    detail::free(allocator, active);
+    return count;
+}
+
+} // detail
+
+// Generates a Poisson disk set and returns the number of points written to buffer, which must have room for
+// sampler.max_samples() points. Returns zero if temporary storage could not be allocated.
+template<unsigned int N, typename T, typename Generator>
+size_t sample(const poisson_disk_sampler<N>& sampler, Generator& generator, T* buffer,
+              const allocator_t& allocator=detail::default_allocator())
+{
+    using Scalar = typename std::decay<decltype(buffer[0])>::type;
+    return detail::sample_poisson_disk<N, Scalar, detail::interleaved_output<N>>(
+        static_cast<const sequential_executor*>(nullptr), sampler, generator, buffer, allocator);
+}
+
+template<unsigned int N, typename T, typename Generator>
+size_t sample_vec(const poisson_disk_sampler<N>& sampler, Generator& generator, T* buffer,
+                  const allocator_t& allocator=detail::default_allocator())
+{
+    using Scalar = typename std::decay<decltype((*buffer)[0])>::type;
+    return detail::sample_poisson_disk<N, Scalar, detail::vector_output>(
+        static_cast<const sequential_executor*>(nullptr), sampler, generator, buffer, allocator);
+}
+
+template<unsigned int N, typename T, typename Generator>
+size_t sample(const poisson_disk_sampler<N>& sampler, Generator& generator, const soa_buffer<T, N>& buffer,
+              const allocator_t& allocator=detail::default_allocator())
+{
+    return detail::sample_poisson_disk<N, T, detail::soa_output>(
+        static_cast<const sequential_executor*>(nullptr), sampler, generator, buffer, allocator);
+}
+
+template<unsigned int N, typename T, typename Generator>
+size_t sample(const poisson_disk_sampler<N>& sampler, Generator& generator, const strided_buffer<T>& buffer,
+              const allocator_t& allocator=detail::default_allocator())
+{
+    return detail::sample_poisson_disk<N, T, detail::strided_output>(
+        static_cast<const sequential_executor*>(nullptr), sampler, generator, buffer, allocator);
+}
+
+// Tiled parallel generation. Generator must be constructible from a 64-bit seed (as all rsm generators are);
+// it's only used to draw the seed of per-tile generators. Joining tiles costs extra candidates along their borders
+// so this is somewhat slower than sequential generation on a single thread.
+template<unsigned int N, typename Executor, typename T, typename Generator>
+size_t sample(const Executor& executor, const poisson_disk_sampler<N>& sampler, Generator& generator, T* buffer,
+              const allocator_t& allocator=detail::default_allocator())
+{
+    using Scalar = typename std::decay<decltype(buffer[0])>::type;
+    return detail::sample_poisson_disk<N, Scalar, detail::interleaved_output<N>>(&executor, sampler, generator, buffer, allocator);
+}
+
+template<unsigned int N, typename Executor, typename T, typename Generator>
+size_t sample_vec(const Executor& executor, const poisson_disk_sampler<N>& sampler, Generator& generator, T* buffer,
+                  const allocator_t& allocator=detail::default_allocator())
+{
+    using Scalar = typename std::decay<decltype((*buffer)[0])>::type;
+    return detail::sample_poisson_disk<N, Scalar, detail::vector_output>(&executor, sampler, generator, buffer, allocator);
+}
+
+template<unsigned int N, typename Executor, typename T, typename Generator>
+size_t sample(const Executor& executor, const poisson_disk_sampler<N>& sampler, Generator& generator, const soa_buffer<T, N>& buffer,
+              const allocator_t& allocator=detail::default_allocator())
+{
+    return detail::sample_poisson_disk<N, T, detail::soa_output>(&executor, sampler, generator, buffer, allocator);
+}
+
+template<unsigned int N, typename Executor, typename T, typename Generator>
+size_t sample(const Executor& executor, const poisson_disk_sampler<N>& sampler, Generator& generator, const strided_buffer<T>& buffer,
+              const allocator_t& allocator=detail::default_allocator())
+{
+    return detail::sample_poisson_disk<N, T, detail::strided_output>(&executor, sampler, generator, buffer, allocator);
+}
+
+} // rsm
@@ -9,6 +9,7 @@
 #include <cstddef>
 #include <type_traits>
 
+#include "../detail/output.hpp"
 #include "../next.hpp"
 
 namespace rsm {
@@ -35,37 +36,52 @@ T sample_vec(random_sampler, Generator& generator)
     return v;
 }
 
-template<unsigned int N, typename T, typename Generator>
-void sample(random_sampler, Generator& generator, T* buffer, size_t count)
+namespace detail {
+
+template<unsigned int N, typename Scalar, typename Output, typename Buffer, typename Generator>
+void sample_random(Generator& generator, Buffer buffer, size_t count)
 {
     static_assert(N > 0, "Requested number of dimensions is not in valid range");
-    using Scalar = typename std::decay<decltype(buffer[0])>::type;
 
-    size_t output_index = 0;
     for(size_t i=0; i<count; ++i) {
         for(unsigned int dim=0; dim<N; ++dim) {
-            buffer[output_index++] = next<Scalar>(generator);
+            Output::store(buffer, i, dim, rsm::next<Scalar>(generator));
         }
     }
 }
 
+} // detail
+
+template<unsigned int N, typename T, typename Generator>
+void sample(random_sampler, Generator& generator, T* buffer, size_t count)
+{
+    using Scalar = typename std::decay<decltype(buffer[0])>::type;
+    detail::sample_random<N, Scalar, detail::interleaved_output<N>>(generator, buffer, count);
+}
+
 template<typename T, typename Generator>
 void sample(random_sampler, Generator& generator, T* buffer, size_t count)
 {
-    sample<1>(generator, buffer, count);
+    sample<1>(random_sampler{}, generator, buffer, count);
 }
 
 template<unsigned int N, typename T, typename Generator>
 void sample_vec(random_sampler, Generator& generator, T* buffer, size_t count)
 {
-    static_assert(N > 0, "Requested number of dimensions is not in valid range");
     using Scalar = typename std::decay<decltype((*buffer)[0])>::type;
+    detail::sample_random<N, Scalar, detail::vector_output>(generator, buffer, count);
+}
 
-    for(size_t i=0; i<count; ++i) {
-        for(unsigned int dim=0; dim<N; ++dim) {
-            buffer[i][dim] = next<Scalar>(generator);
-        }
-    }
+template<unsigned int N, typename T, typename Generator>
+void sample(random_sampler, Generator& generator, const soa_buffer<T, N>& buffer, size_t count)
+{
+    detail::sample_random<N, T, detail::soa_output>(generator, buffer, count);
+}
+
+template<unsigned int N, typename T, typename Generator>
+void sample(random_sampler, Generator& generator, const strided_buffer<T>& buffer, size_t count)
+{
+    detail::sample_random<N, T, detail::strided_output>(generator, buffer, count);
 }
 
 } // rsm
@@ -6,16 +6,19 @@
 
 #pragma once
 
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <algorithm>
 #include <array>
 #include <type_traits>
 
 #include "../detail/common.hpp"
+#include "../detail/hash.hpp"
+#include "../detail/output.hpp"
 #include "../next.hpp"
 #include "../range.hpp"
 #include "../options.hpp"
-#include "../utils.hpp"
 
 #include "lhs.hpp"
 
@@ -51,7 +54,7 @@ struct stratified_sampler
 };
 
 template<unsigned int N, typename T, unsigned int MaxDim>
-range_t<N, T> range(T* buffer, const stratified_sampler<MaxDim>& sampler, uint16_t stride=1)
+range_t<N, T> range(T* buffer, const stratified_sampler<MaxDim>& sampler, size_t stride=1)
 {
     std::array<size_t, N> range_size;
     for(unsigned int i=0; i<N; ++i) {
@@ -60,11 +63,23 @@ range_t<N, T> range(T* buffer, const stratified_sampler<MaxDim>& sampler, uint16
     return range_t<N, T>{buffer, range_size, stride};
 }
 
-template<unsigned int N, typename T, typename Generator, unsigned int MaxDim>
-void sample(const stratified_sampler<MaxDim>& sampler, Generator& generator, T* buffer, size_t count=0)
+template<unsigned int N, unsigned int MaxDim>
+grid_t<N> grid(const stratified_sampler<MaxDim>& sampler)
+{
+    static_assert(N > 0 && N <= MaxDim, "Requested number of dimensions is not in valid range");
+    std::array<size_t, N> grid_size;
+    for(unsigned int i=0; i<N; ++i) {
+        grid_size[i] = sampler.strata[i];
+    }
+    return grid_t<N>{grid_size};
+}
+
+namespace detail {
+
+template<unsigned int N, typename Scalar, typename Output, typename Buffer, typename Generator, unsigned int MaxDim>
+void sample_stratified(const stratified_sampler<MaxDim>& sampler, Generator& generator, Buffer buffer, size_t count)
 {
     static_assert(N > 0 && N <= MaxDim, "Requested number of dimensions is not in valid range");
-    using Scalar = typename std::decay<decltype(buffer[0])>::type;
 
     size_t requested_samples = (count > 0) ? count : sampler.total_strata(N);
 
@@ -74,31 +89,60 @@ void sample(const stratified_sampler<MaxDim>& sampler, Generator& generator, T*
         for(unsigned int dim=0; dim<N; ++dim) {
             delta[dim] = Scalar(1.0) / sampler.strata[dim];
         }
+        // Strata are enumerated with the first dimension varying fastest.
         if(sampler.options & opt::jitter) {
-            for(auto it : range<N>(buffer, sampler, N)) {
-                for(unsigned int dim=0; dim<N; ++dim) {
-                    Scalar jitter = next<Scalar>(generator);
-                    it.value[dim] = detail::variate<Scalar>((it.index[dim] + jitter) * delta[dim]);
+            grid<N>(sampler).for_each_span([&](size_t first, const std::array<size_t, N>& index, size_t span_count) {
+                for(size_t j=0; j<span_count; ++j) {
+                    Scalar jitter = rsm::next<Scalar>(generator);
+                    Output::store(buffer, first + j, 0, detail::variate<Scalar>((index[0] + j + jitter) * delta[0]));
+                    for(unsigned int dim=1; dim<N; ++dim) {
+                        jitter = rsm::next<Scalar>(generator);
+                        Output::store(buffer, first + j, dim, detail::variate<Scalar>((index[dim] + jitter) * delta[dim]));
+                    }
                 }
-            }
+            });
         }
         else {
-            for(auto it : range<N>(buffer, sampler, N)) {
-                for(unsigned int dim=0; dim<N; ++dim) {
-                    it.value[dim] = detail::variate<Scalar>((it.index[dim] + Scalar(0.5)) * delta[dim]);
+            grid<N>(sampler).for_each_span([&](size_t first, const std::array<size_t, N>& index, size_t span_count) {
+                Scalar value[N];
+                for(unsigned int dim=1; dim<N; ++dim) {
+                    value[dim] = detail::variate<Scalar>((index[dim] + Scalar(0.5)) * delta[dim]);
                 }
-            }
+                for(size_t j=0; j<span_count; ++j) {
+                    Output::store(buffer, first + j, 0, detail::variate<Scalar>((index[0] + j + Scalar(0.5)) * delta[0]));
+                }
+                for(unsigned int dim=1; dim<N; ++dim) {
+                    for(size_t j=0; j<span_count; ++j) {
+                        Output::store(buffer, first + j, dim, value[dim]);
+                    }
+                }
+            });
         }
         if(sampler.options & opt::shuffle) {
-            shuffle<N>(generator, &buffer[0], &buffer[N * requested_samples]);
+            const uint32_t n = static_cast<uint32_t>(requested_samples);
+            for(uint32_t i=0; i<n; ++i) {
+                uint32_t r = rsm::next(generator, i, n);
+                for(unsigned int dim=0; dim<N; ++dim) {
+                    Output::swap(buffer, i, r, dim);
+                }
+            }
         }
     }
     // Otherwise perform Latin hypercube sampling (LHS).
     else {
-        sample<N>(lhs_sampler{sampler.options}, generator, buffer, requested_samples);
+        sample_lhs<N, Scalar, Output>(lhs_sampler{sampler.options}, generator, buffer, requested_samples);
     }
 }
 
+} // detail
+
+template<unsigned int N, typename T, typename Generator, unsigned int MaxDim>
+void sample(const stratified_sampler<MaxDim>& sampler, Generator& generator, T* buffer, size_t count=0)
+{
+    using Scalar = typename std::decay<decltype(buffer[0])>::type;
+    detail::sample_stratified<N, Scalar, detail::interleaved_output<N>>(sampler, generator, buffer, count);
+}
+
 template<typename T, typename Generator, unsigned int MaxDim>
 void sample(const stratified_sampler<MaxDim>& sampler, Generator& generator, T* buffer, size_t count=0)
 {
@@ -108,40 +152,102 @@ void sample(const stratified_sampler<MaxDim>& sampler, Generator& generator, T*
 template<unsigned int N, typename T, typename Generator, unsigned int MaxDim>
 void sample_vec(const stratified_sampler<MaxDim>& sampler, Generator& generator, T* buffer, size_t count=0)
 {
-    static_assert(N > 0 && N <= MaxDim, "Requested number of dimensions is not in valid range");
     using Scalar = typename std::decay<decltype((*buffer)[0])>::type;
+    detail::sample_stratified<N, Scalar, detail::vector_output>(sampler, generator, buffer, count);
+}
 
-    size_t requested_samples = (count > 0) ? count : sampler.total_strata(N);
+template<unsigned int N, typename T, typename Generator, unsigned int MaxDim>
+void sample(const stratified_sampler<MaxDim>& sampler, Generator& generator, const soa_buffer<T, N>& buffer, size_t count=0)
+{
+    detail::sample_stratified<N, T, detail::soa_output>(sampler, generator, buffer, count);
+}
 
-    // If # of requested samples matches strata configuration do regular sampling.
-    if(requested_samples == sampler.total_strata(N)) {
-        Scalar delta[N];
+template<unsigned int N, typename T, typename Generator, unsigned int MaxDim>
+void sample(const stratified_sampler<MaxDim>& sampler, Generator& generator, const strided_buffer<T>& buffer, size_t count=0)
+{
+    detail::sample_stratified<N, T, detail::strided_output>(sampler, generator, buffer, count);
+}
+
+namespace detail {
+
+// Jitter of every stratum is a stateless function of (seed, stratum, dimension): each dimension hashes
+// the stratum index into its own SplitMix64 stream. Any sub-range of strata can therefore be generated
+// independently (e.g. on different threads) and always produces the same values.
+template<unsigned int N, typename Scalar, typename Output, typename Buffer, unsigned int MaxDim>
+void sample_strata(const stratified_sampler<MaxDim>& sampler, uint64_t seed, Buffer buffer, size_t begin, size_t end)
+{
+    static_assert(N > 0 && N <= MaxDim, "Requested number of dimensions is not in valid range");
+
+    Scalar delta[N];
+    uint64_t key[N];
+    for(unsigned int dim=0; dim<N; ++dim) {
+        delta[dim] = Scalar(1.0) / sampler.strata[dim];
+        key[dim] = hash(seed, dim);
+    }
+    const bool jitter = (sampler.options & opt::jitter) != 0;
+    grid<N>(sampler).for_each_span(begin, end, [&](size_t first, const std::array<size_t, N>& index, size_t span_count) {
+        const size_t offset = first - begin;
         for(unsigned int dim=0; dim<N; ++dim) {
-            delta[dim] = Scalar(1.0) / sampler.strata[dim];
-        }
-        if(sampler.options & opt::jitter) {
-            for(auto it : range<N>(buffer, sampler)) {
-                for(unsigned int dim=0; dim<N; ++dim) {
-                    Scalar jitter = next<Scalar>(generator);
-                    (*it.value)[dim] = detail::variate<Scalar>((it.index[dim] + jitter) * delta[dim]);
-                }
+            const uint64_t stream = key[dim] + first * 0x9e3779b97f4a7c15ull;
+            const size_t step = (dim == 0) ? 1 : 0;
+            for(size_t j=0; j<span_count; ++j) {
+                const Scalar u = jitter ? hash_variate<Scalar>(mix64(stream + j * 0x9e3779b97f4a7c15ull)) : Scalar(0.5);
+                Output::store(buffer, offset + j, dim, variate<Scalar>((index[dim] + j * step + u) * delta[dim]));
             }
         }
-        else {
-            for(auto it : range<N>(buffer, sampler)) {
-                for(unsigned int dim=0; dim<N; ++dim) {
-                    (*it.value)[dim] = detail::variate<Scalar>((it.index[dim] + Scalar(0.5)) * delta[dim]);
-                }
-            }
-        }
-        if(sampler.options & opt::shuffle) {
-            shuffle(generator, &buffer[0], &buffer[requested_samples]);
-        }
-    }
-    // Otherwise perform Latin hypercube sampling (LHS).
-    else {
-        sample_vec<N>(lhs_sampler{sampler.options}, generator, buffer, requested_samples);
-    }
+    });
+}
+
+} // detail
+
+// Counter-based stratified sampling: fills strata [first, first + count) of the full stratified set
+// (count of zero means all remaining strata) in linear stratum order with the first dimension varying fastest.
+// Output doesn't depend on how the set is split so large sets can be generated in parallel.
+// Shuffle option is ignored.
+template<unsigned int N, typename T, unsigned int MaxDim>
+void sample_strata(const stratified_sampler<MaxDim>& sampler, uint64_t seed, T* buffer, size_t first=0, size_t count=0)
+{
+    using Scalar = typename std::decay<decltype(buffer[0])>::type;
+    const size_t end = (count > 0) ? first + count : sampler.total_strata(N);
+    assert(end <= sampler.total_strata(N));
+    detail::sample_strata<N, Scalar, detail::interleaved_output<N>>(sampler, seed, buffer, first, end);
+}
+
+template<unsigned int N, typename T, unsigned int MaxDim>
+void sample_strata_vec(const stratified_sampler<MaxDim>& sampler, uint64_t seed, T* buffer, size_t first=0, size_t count=0)
+{
+    using Scalar = typename std::decay<decltype((*buffer)[0])>::type;
+    const size_t end = (count > 0) ? first + count : sampler.total_strata(N);
+    assert(end <= sampler.total_strata(N));
+    detail::sample_strata<N, Scalar, detail::vector_output>(sampler, seed, buffer, first, end);
+}
+
+template<unsigned int N, typename T, unsigned int MaxDim>
+void sample_strata(const stratified_sampler<MaxDim>& sampler, uint64_t seed, const soa_buffer<T, N>& buffer, size_t first=0, size_t count=0)
+{
+    const size_t end = (count > 0) ? first + count : sampler.total_strata(N);
+    assert(end <= sampler.total_strata(N));
+    detail::sample_strata<N, T, detail::soa_output>(sampler, seed, buffer, first, end);
+}
+
+template<unsigned int N, typename T, unsigned int MaxDim>
+void sample_strata(const stratified_sampler<MaxDim>& sampler, uint64_t seed, const strided_buffer<T>& buffer, size_t first=0, size_t count=0)
+{
+    const size_t end = (count > 0) ? first + count : sampler.total_strata(N);
+    assert(end <= sampler.total_strata(N));
+    detail::sample_strata<N, T, detail::strided_output>(sampler, seed, buffer, first, end);
+}
+
+// Generates the whole stratified set in parallel, split into rows of strata.
+template<unsigned int N, typename Executor, typename T, unsigned int MaxDim>
+void sample_strata(const Executor& executor, const stratified_sampler<MaxDim>& sampler, uint64_t seed, T* buffer)
+{
+    const size_t total = sampler.total_strata(N);
+    const size_t task_size = std::max<size_t>(sampler.strata[0], 4096);
+    executor.parallel_for((total + task_size - 1) / task_size, [&](size_t task) {
+        const size_t first = task * task_size;
+        sample_strata<N>(sampler, seed, buffer + N * first, first, std::min(task_size, total - first));
+    });
 }
 
 } // rsm
@@ -0,0 +1,227 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <array>
+
+#include "detail/common.hpp"
+
+#ifdef RSM_ENABLE_STATS
+#include <atomic>
+#include <mutex>
+#include <vector>
+#endif
+
+namespace rsm {
+
+// Instrumentation counters; only collected if RSM_ENABLE_STATS is defined (consistently in every translation unit),
+// otherwise all counting macros expand to nothing and get_stats() always returns zeros.
+struct stats_t
+{
+    // Calls to operator() of built-in generators.
+    uint64_t generator_calls;
+    // Additional generator calls made by rejection loops of bounded next<uint32_t>() and next<uint64_t>().
+    uint64_t bounded32_retries;
+    uint64_t bounded64_retries;
+    // Successful allocations made through allocator_t and their total size in bytes.
+    uint64_t num_allocations;
+    uint64_t bytes_allocated;
+    // Samples drawn from each radical inverse dimension (absolute, i.e. including sampler's base dimension) by Halton,
+    // Hammersley (except its first dimension) and halton_pixel samplers, and QMC dimensions of padded_sampler.
+    std::array<uint64_t, RSM_MAX_LDS_DIMENSIONS> dimension_samples;
+    // Samples drawn from dimensions at or above RSM_MAX_LDS_DIMENSIONS.
+    uint64_t other_dimension_samples;
+};
+
+#ifdef RSM_ENABLE_STATS
+
+constexpr bool stats_enabled = true;
+
+namespace detail {
+
+// Counters are only ever written by their owning thread so plain relaxed load & store is enough (no locked
+// read-modify-write); atomics make concurrent snapshots by other threads well defined.
+// Reset doesn't write counters either; it records current values as a baseline subtracted from later snapshots.
+struct stats_counters
+{
+    std::atomic<uint64_t> generator_calls;
+    std::atomic<uint64_t> bounded32_retries;
+    std::atomic<uint64_t> bounded64_retries;
+    std::atomic<uint64_t> num_allocations;
+    std::atomic<uint64_t> bytes_allocated;
+    std::atomic<uint64_t> dimension_samples[RSM_MAX_LDS_DIMENSIONS];
+    std::atomic<uint64_t> other_dimension_samples;
+    // Guarded by stats_registry mutex.
+    stats_t baseline;
+};
+
+inline void stats_add(std::atomic<uint64_t>& counter, uint64_t n)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+inline void stats_add_dimension(stats_counters& counters, unsigned int dim, uint64_t n)
+{
+    stats_add((dim < RSM_MAX_LDS_DIMENSIONS) ? counters.dimension_samples[dim] : counters.other_dimension_samples, n);
+}
+
+inline stats_t stats_load(const stats_counters& counters)
+{
+    stats_t stats;
+    stats.generator_calls   = counters.generator_calls.load(std::memory_order_relaxed);
+    stats.bounded32_retries = counters.bounded32_retries.load(std::memory_order_relaxed);
+    stats.bounded64_retries = counters.bounded64_retries.load(std::memory_order_relaxed);
+    stats.num_allocations   = counters.num_allocations.load(std::memory_order_relaxed);
+    stats.bytes_allocated   = counters.bytes_allocated.load(std::memory_order_relaxed);
+    for(unsigned int i=0; i<RSM_MAX_LDS_DIMENSIONS; ++i) {
+        stats.dimension_samples[i] = counters.dimension_samples[i].load(std::memory_order_relaxed);
+    }
+    stats.other_dimension_samples = counters.other_dimension_samples.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// Adds (a - b) to stats.
+inline void stats_accumulate(stats_t& stats, const stats_t& a, const stats_t& b)
+{
+    stats.generator_calls   += a.generator_calls - b.generator_calls;
+    stats.bounded32_retries += a.bounded32_retries - b.bounded32_retries;
+    stats.bounded64_retries += a.bounded64_retries - b.bounded64_retries;
+    stats.num_allocations   += a.num_allocations - b.num_allocations;
+    stats.bytes_allocated   += a.bytes_allocated - b.bytes_allocated;
+    for(unsigned int i=0; i<RSM_MAX_LDS_DIMENSIONS; ++i) {
+        stats.dimension_samples[i] += a.dimension_samples[i] - b.dimension_samples[i];
+    }
+    stats.other_dimension_samples += a.other_dimension_samples - b.other_dimension_samples;
+}
+
+// Keeps track of counters of all live threads; counters of exited threads are merged into a retired total.
+class stats_registry
+{
+public:
+    static stats_registry& get()
+    {
+        static stats_registry registry;
+        return registry;
+    }
+
+    void attach(stats_counters* counters)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        counters->baseline = stats_load(*counters);
+        m_threads.push_back(counters);
+    }
+
+    void detach(stats_counters* counters)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        stats_accumulate(m_retired, stats_load(*counters), counters->baseline);
+        for(size_t i=0; i<m_threads.size(); ++i) {
+            if(m_threads[i] == counters) {
+                m_threads[i] = m_threads.back();
+                m_threads.pop_back();
+                break;
+            }
+        }
+    }
+
+    stats_t snapshot()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        stats_t stats = m_retired;
+        for(const stats_counters* counters : m_threads) {
+            stats_accumulate(stats, stats_load(*counters), counters->baseline);
+        }
+        return stats;
+    }
+
+    // Counts made by other threads concurrently with reset are attributed to either side of it, but never lost.
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_retired = stats_t{};
+        for(stats_counters* counters : m_threads) {
+            counters->baseline = stats_load(*counters);
+        }
+    }
+
+private:
+    stats_registry()
+        : m_retired{}
+    {}
+
+    std::mutex m_mutex;
+    std::vector<stats_counters*> m_threads;
+    stats_t m_retired;
+};
+
+class thread_stats : public stats_counters
+{
+public:
+    static thread_stats& local()
+    {
+        static thread_local thread_stats stats;
+        return stats;
+    }
+
+    ~thread_stats()
+    {
+        stats_registry::get().detach(this);
+    }
+
+private:
+    thread_stats()
+    {
+        generator_calls.store(0, std::memory_order_relaxed);
+        bounded32_retries.store(0, std::memory_order_relaxed);
+        bounded64_retries.store(0, std::memory_order_relaxed);
+        num_allocations.store(0, std::memory_order_relaxed);
+        bytes_allocated.store(0, std::memory_order_relaxed);
+        for(unsigned int i=0; i<RSM_MAX_LDS_DIMENSIONS; ++i) {
+            dimension_samples[i].store(0, std::memory_order_relaxed);
+        }
+        other_dimension_samples.store(0, std::memory_order_relaxed);
+        stats_registry::get().attach(this);
+    }
+};
+
+} // detail
+
+// Counters of all threads (both live and exited) summed together.
+inline stats_t get_stats()
+{
+    return detail::stats_registry::get().snapshot();
+}
+
+inline void reset_stats()
+{
+    detail::stats_registry::get().reset();
+}
+
+#define RSM_STATS_ADD(counter, n) \
+    ::rsm::detail::stats_add(::rsm::detail::thread_stats::local().counter, (n))
+#define RSM_STATS_ADD_DIMENSION(dim, n) \
+    ::rsm::detail::stats_add_dimension(::rsm::detail::thread_stats::local(), (dim), (n))
+
+#else
+
+constexpr bool stats_enabled = false;
+
+inline stats_t get_stats()
+{
+    return stats_t{};
+}
+
+inline void reset_stats()
+{}
+
+#define RSM_STATS_ADD(counter, n) ((void)0)
+#define RSM_STATS_ADD_DIMENSION(dim, n) ((void)0)
+
+#endif // RSM_ENABLE_STATS
+
+} // rsm
@@ -0,0 +1,266 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <rsm/rsm.hpp>
+
+#include "testing.hpp"
+
+namespace rsm_tests {
+namespace {
+
+template<typename Generator>
+uint32_t high_bits(Generator& generator, unsigned int bits)
+{
+    using result_type = typename Generator::result_type;
+    return static_cast<uint32_t>(generator() >> (std::numeric_limits<result_type>::digits - bits));
+}
+
+// Uniformity of the highest and lowest byte of raw output.
+template<typename Generator>
+void test_buckets(context& ctx, const std::string& name, Generator generator)
+{
+    const size_t n = ctx.scale(size_t(1) << 20);
+    std::vector<size_t> high(256), low(256);
+    for(size_t i=0; i<n; ++i) {
+        const auto value = generator();
+        ++high[value >> (std::numeric_limits<decltype(value)>::digits - 8)];
+        ++low[value & 0xff];
+    }
+    const std::vector<double> probability(256, 1.0 / 256);
+    ctx.check_p(name + "/chi_square_high", chi_square_cdf(chi_square(high.data(), probability.data(), 256, n), 255));
+    ctx.check_p(name + "/chi_square_low", chi_square_cdf(chi_square(low.data(), probability.data(), 256, n), 255));
+}
+
+// Uniformity of pairs of consecutive outputs on a 16x16 grid.
+template<typename Generator>
+void test_serial_pairs(context& ctx, const std::string& name, Generator generator)
+{
+    const size_t n = ctx.scale(size_t(1) << 20);
+    std::vector<size_t> cells(256);
+    for(size_t i=0; i<n; ++i) {
+        const uint32_t x = high_bits(generator, 4);
+        const uint32_t y = high_bits(generator, 4);
+        ++cells[y * 16 + x];
+    }
+    const std::vector<double> probability(256, 1.0 / 256);
+    ctx.check_p(name + "/chi_square_pairs", chi_square_cdf(chi_square(cells.data(), probability.data(), 256, n), 255));
+}
+
+// Bounded integers through rsm::next() with a range that's not a power of two.
+template<typename Generator>
+void test_bounded(context& ctx, const std::string& name, Generator generator)
+{
+    const size_t n = ctx.scale(size_t(1) << 20);
+    const uint32_t range = 1000003;
+    const size_t num_buckets = 61;
+    std::vector<size_t> buckets(num_buckets);
+    for(size_t i=0; i<n; ++i) {
+        ++buckets[rsm::next<uint32_t>(generator, 0, range) % num_buckets];
+    }
+    std::vector<double> probability(num_buckets);
+    for(size_t i=0; i<num_buckets; ++i) {
+        probability[i] = double(range / num_buckets + (i < range % num_buckets ? 1 : 0)) / range;
+    }
+    ctx.check_p(name + "/chi_square_bounded", chi_square_cdf(chi_square(buckets.data(), probability.data(), num_buckets, n), num_buckets - 1));
+}
+
+// Lengths of gaps between consecutive variates falling into [0, 1/8).
+// See: D. Knuth, "The Art of Computer Programming", Vol. 2, 3.3.2.
+template<typename Generator>
+void test_gap(context& ctx, const std::string& name, Generator generator)
+{
+    const size_t num_gaps = ctx.scale(size_t(1) << 18);
+    const double p = 0.125;
+    const size_t max_gap = 32;
+    std::vector<size_t> gaps(max_gap + 1);
+    for(size_t i=0; i<num_gaps; ++i) {
+        size_t length = 0;
+        while(rsm::next<double>(generator) >= p) {
+            ++length;
+        }
+        ++gaps[std::min(length, max_gap)];
+    }
+    std::vector<double> probability(max_gap + 1);
+    for(size_t k=0; k<max_gap; ++k) {
+        probability[k] = p * std::pow(1.0 - p, double(k));
+    }
+    probability[max_gap] = std::pow(1.0 - p, double(max_gap));
+    ctx.check_p(name + "/gap", chi_square_cdf(chi_square(gaps.data(), probability.data(), max_gap + 1, num_gaps), max_gap));
+}
+
+// Marsaglia's birthday spacings: m birthdays in a year of 2^30 days; number of repeated spacings
+// summed over all repetitions is Poisson distributed with mean m^3 / (4 * 2^30) per repetition.
+// Year is long enough for the Poisson approximation to hold in long mode as well.
+template<typename Generator>
+void test_birthday_spacings(context& ctx, const std::string& name, Generator generator)
+{
+    const size_t m = 2048;
+    const size_t repetitions = ctx.scale(512);
+    const double lambda = double(m) * m * m / (4.0 * (1 << 30));
+
+    std::vector<uint32_t> birthdays(m), spacings(m);
+    size_t total = 0;
+    for(size_t r=0; r<repetitions; ++r) {
+        for(size_t i=0; i<m; ++i) {
+            birthdays[i] = high_bits(generator, 30);
+        }
+        std::sort(birthdays.begin(), birthdays.end());
+        spacings[0] = birthdays[0];
+        for(size_t i=1; i<m; ++i) {
+            spacings[i] = birthdays[i] - birthdays[i-1];
+        }
+        std::sort(spacings.begin(), spacings.end());
+        for(size_t i=1; i<m; ++i) {
+            total += (spacings[i] == spacings[i-1]) ? 1 : 0;
+        }
+    }
+    ctx.check_p(name + "/birthday_spacings", poisson_cdf(double(total), lambda * repetitions));
+}
+
+// Correlation between variates lag apart; sqrt(n) * r is approximately standard normal.
+template<typename Generator>
+void test_serial_correlation(context& ctx, const std::string& name, Generator generator, size_t lag)
+{
+    const size_t n = ctx.scale(size_t(1) << 20);
+    std::vector<double> history(lag);
+    for(size_t i=0; i<lag; ++i) {
+        history[i] = rsm::next<double>(generator);
+    }
+    double sum_xy = 0.0;
+    for(size_t i=0; i<n; ++i) {
+        const double x = history[i % lag];
+        const double y = rsm::next<double>(generator);
+        history[i % lag] = y;
+        sum_xy += (x - 0.5) * (y - 0.5);
+    }
+    // Variance of a uniform variate is 1/12.
+    const double r = 12.0 * sum_xy / n;
+    ctx.check_p(name + "/serial_correlation_lag" + std::to_string(lag), normal_cdf(r * std::sqrt(double(n))));
+}
+
+template<typename Generator>
+void test_generator(context& ctx, const std::string& name)
+{
+    const std::string prefix = "generators/" + name;
+    test_buckets(ctx, prefix, Generator(0x5eed0001));
+    test_serial_pairs(ctx, prefix, Generator(0x5eed0002));
+    test_bounded(ctx, prefix, Generator(0x5eed0003));
+    test_gap(ctx, prefix, Generator(0x5eed0004));
+    test_birthday_spacings(ctx, prefix, Generator(0x5eed0005));
+    test_serial_correlation(ctx, prefix, Generator(0x5eed0006), 1);
+    test_serial_correlation(ctx, prefix, Generator(0x5eed0007), 7);
+}
+
+// User-defined full range generator without a specialized variate conversion.
+struct lcg64
+{
+    using result_type = uint64_t;
+
+    explicit lcg64(uint64_t seed)
+        : state(seed)
+    {}
+
+    result_type operator()()
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return state;
+    }
+
+    static constexpr result_type min()
+    {
+        return 0;
+    }
+
+    static constexpr result_type max()
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    uint64_t state;
+};
+
+// Buffered adapter has to reproduce the wrapped generator's sequence exactly, including float conversions.
+template<typename Generator>
+void test_buffered(context& ctx, const std::string& name)
+{
+    Generator generator(0x5eed0008);
+    rsm::buffered_generator<Generator, 37> buffered(0x5eed0008);
+    size_t mismatches = 0;
+    const size_t n = 4096;
+    for(size_t i=0; i<n; ++i) {
+        mismatches += (generator() != buffered()) ? 1 : 0;
+        mismatches += (rsm::next<float>(generator) != rsm::next<float>(buffered)) ? 1 : 0;
+        mismatches += (rsm::next<double>(generator) != rsm::next<double>(buffered)) ? 1 : 0;
+        mismatches += (rsm::next<uint32_t>(generator, 0, 1000) != rsm::next<uint32_t>(buffered, 0, 1000)) ? 1 : 0;
+    }
+    ctx.check("generators/" + name + "/buffered_sequence", mismatches == 0, "%zu mismatches in %zu draws", mismatches, 4 * n);
+}
+
+template<typename Generator>
+int stream(unsigned long long num_bytes)
+{
+    using result_type = typename Generator::result_type;
+    const size_t block_size = 4096;
+    std::vector<result_type> block(block_size);
+    Generator generator;
+    for(unsigned long long written=0; num_bytes == 0 || written < num_bytes; written += sizeof(block[0]) * block_size) {
+        for(auto& value : block) {
+            value = generator();
+        }
+        const size_t count = (num_bytes == 0) ? block_size
+            : static_cast<size_t>(std::min<unsigned long long>(block_size, (num_bytes - written + sizeof(block[0]) - 1) / sizeof(block[0])));
+        if(std::fwrite(block.data(), sizeof(block[0]), count, stdout) != count) {
+            // Reader closed the pipe.
+            return 0;
+        }
+    }
+    std::fflush(stdout);
+    return 0;
+}
+
+} // namespace
+
+void generator_tests(context& ctx)
+{
+    test_generator<rsm::pcg32>(ctx, "pcg32");
+    test_generator<rsm::splitmix64>(ctx, "splitmix64");
+    test_generator<rsm::xoroshiro128p>(ctx, "xoroshiro128p");
+    test_generator<rsm::xoroshiro64s>(ctx, "xoroshiro64s");
+
+    test_buffered<rsm::pcg32>(ctx, "pcg32");
+    test_buffered<rsm::splitmix64>(ctx, "splitmix64");
+    test_buffered<rsm::xoroshiro128p>(ctx, "xoroshiro128p");
+    test_buffered<rsm::xoroshiro64s>(ctx, "xoroshiro64s");
+    test_buffered<lcg64>(ctx, "lcg64");
+}
+
+int stream_generator(const std::string& name, unsigned long long num_bytes)
+{
+    if(name == "pcg32") {
+        return stream<rsm::pcg32>(num_bytes);
+    }
+    else if(name == "splitmix64") {
+        return stream<rsm::splitmix64>(num_bytes);
+    }
+    else if(name == "xoroshiro128p") {
+        return stream<rsm::xoroshiro128p>(num_bytes);
+    }
+    else if(name == "xoroshiro64s") {
+        return stream<rsm::xoroshiro64s>(num_bytes);
+    }
+    std::fprintf(stderr, "unknown generator: %s\n", name.c_str());
+    return 2;
+}
+
+} // rsm_tests
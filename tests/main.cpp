@@ -0,0 +1,69 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "testing.hpp"
+
+namespace {
+
+void usage()
+{
+    std::fprintf(stderr,
+        "usage: rsm_tests [--long] [generators|samplers]...\n"
+        "       rsm_tests --stream <generator> [bytes]\n"
+        "\n"
+        "  --long      run statistical tests on 64 times more samples\n"
+        "  --stream    write raw output of generator to stdout (e.g. for PractRand: rsm_tests --stream pcg32 | RNG_test stdin32);\n"
+        "              streams until the pipe is closed unless a number of bytes is given\n"
+        "  generators: pcg32, splitmix64, xoroshiro128p, xoroshiro64s\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    bool long_mode = false;
+    bool run_generators = false;
+    bool run_samplers = false;
+
+    for(int i=1; i<argc; ++i) {
+        if(std::strcmp(argv[i], "--stream") == 0 && i+1 < argc) {
+            const unsigned long long num_bytes = (i+2 < argc) ? std::strtoull(argv[i+2], nullptr, 10) : 0;
+            return rsm_tests::stream_generator(argv[i+1], num_bytes);
+        }
+        else if(std::strcmp(argv[i], "--long") == 0) {
+            long_mode = true;
+        }
+        else if(std::strcmp(argv[i], "generators") == 0) {
+            run_generators = true;
+        }
+        else if(std::strcmp(argv[i], "samplers") == 0) {
+            run_samplers = true;
+        }
+        else {
+            usage();
+            return 2;
+        }
+    }
+    if(!run_generators && !run_samplers) {
+        run_generators = run_samplers = true;
+    }
+
+    rsm_tests::context ctx(long_mode);
+    if(run_generators) {
+        rsm_tests::generator_tests(ctx);
+    }
+    if(run_samplers) {
+        rsm_tests::sampler_tests(ctx);
+    }
+
+    std::printf("%d of %d checks passed\n", ctx.num_checks - ctx.num_failures, ctx.num_checks);
+    return (ctx.num_failures > 0) ? 1 : 0;
+}
@@ -0,0 +1,185 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <algorithm>
+#include <random>
+#include <type_traits>
+#include <string>
+#include <vector>
+
+#include <rsm/rsm.hpp>
+
+#include "testing.hpp"
+
+namespace rsm_tests {
+namespace {
+
+// Discrepancy is reported relative to the expected value for n independent uniform points,
+// which is sqrt((2^-d - 3^-d) / n).
+template<unsigned int N>
+void check_discrepancy(context& ctx, const std::string& name, const std::vector<double>& points, double max_ratio)
+{
+    const size_t n = points.size() / N;
+    const double expected_random = std::sqrt((std::pow(2.0, -double(N)) - std::pow(3.0, -double(N))) / n);
+    const double ratio = rsm::l2_star_discrepancy<N>(points.data(), n) / expected_random;
+    ctx.check(name, ratio < max_ratio, "n=%zu T/T_random=%.4f (limit %.2f)", n, ratio, max_ratio);
+}
+
+template<unsigned int N>
+void test_discrepancy(context& ctx, size_t n, uint32_t strata_per_dim)
+{
+    const std::string suffix = "/l2_star_" + std::to_string(N) + "d";
+    std::vector<double> points(N * n);
+
+    rsm::pcg32 generator(0x5eed0101);
+    rsm::sample<N>(rsm::random_sampler{}, generator, points.data(), n);
+    check_discrepancy<N>(ctx, "samplers/random" + suffix, points, 3.0);
+
+    rsm::sample<N>(rsm::lhs_sampler{}, generator, points.data(), n);
+    check_discrepancy<N>(ctx, "samplers/lhs" + suffix, points, 1.0);
+
+    rsm::halton_sampler<N> halton;
+    rsm::sample<N>(halton, points.data(), n);
+    check_discrepancy<N>(ctx, "samplers/halton" + suffix, points, 0.35);
+
+    rsm::hammersley_sampler<N> hammersley(n);
+    rsm::sample<N>(hammersley, points.data(), n);
+    check_discrepancy<N>(ctx, "samplers/hammersley" + suffix, points, 0.35);
+
+    const auto lattice = rsm::lattice_sampler<N>::precomputed(static_cast<uint32_t>(n));
+    rsm::sample<N>(lattice, points.data(), n);
+    check_discrepancy<N>(ctx, "samplers/lattice" + suffix, points, 0.35);
+
+    rsm::cmj_sampler<N> cmj(static_cast<uint32_t>(n), 0x5eed0102);
+    rsm::sample<N>(cmj, points.data(), n);
+    check_discrepancy<N>(ctx, "samplers/cmj" + suffix, points, 0.6);
+
+    size_t num_strata = 1;
+    for(unsigned int i=0; i<N; ++i) {
+        num_strata *= strata_per_dim;
+    }
+    std::vector<double> strata_points(N * num_strata);
+    rsm::stratified_sampler<N> stratified(strata_per_dim);
+    rsm::sample<N>(stratified, generator, strata_points.data());
+    check_discrepancy<N>(ctx, "samplers/stratified" + suffix, strata_points, 0.6);
+}
+
+// Fast two dimensional star discrepancy against Warnock's formula, executor independence of quadratic metrics
+// and invariance of wrap-around discrepancy to toroidal shifts.
+void test_metrics(context& ctx, size_t n)
+{
+    std::vector<double> points(2 * n);
+    rsm::pcg32 generator(0x5eed0103);
+    rsm::sample<2>(rsm::random_sampler{}, generator, points.data(), n);
+
+    const rsm::thread_executor executor;
+    const double fast = rsm::l2_star_discrepancy<2>(points.data(), n);
+    const double warnock = std::sqrt(std::max(0.0, rsm::detail::l2_star_discrepancy_sqr<2>(points.data(), n, executor, std::false_type{})));
+    ctx.check("metrics/l2_star_2d_fast", std::abs(fast - warnock) < 1e-9 * warnock, "fast=%.9f warnock=%.9f", fast, warnock);
+
+    const double sequential = rsm::l2_star_discrepancy<3>(points.data(), n / 3);
+    const double parallel = rsm::l2_star_discrepancy<3>(points.data(), n / 3, executor);
+    ctx.check("metrics/l2_star_executor", sequential == parallel, "sequential=%.9f parallel=%.9f", sequential, parallel);
+
+    const double wraparound = rsm::wraparound_discrepancy<2>(points.data(), n, executor);
+    for(double& x : points) {
+        x = std::fmod(x + 0.375, 1.0);
+    }
+    const double shifted = rsm::wraparound_discrepancy<2>(points.data(), n, executor);
+    ctx.check("metrics/wraparound_shift", std::abs(wraparound - shifted) < 1e-9 * wraparound, "original=%.9f shifted=%.9f", wraparound, shifted);
+}
+
+// Poisson disk samples are at least radius apart; mean nearest neighbor distance is reported relative to radius.
+// Large radii with few points per set are repeated over many seeds.
+template<unsigned int N>
+void test_poisson_disk(context& ctx, double radius, size_t repetitions=1)
+{
+    char name[64];
+    std::snprintf(name, sizeof(name), "samplers/poisson_disk/min_distance_%ud_r%g", N, radius);
+    const rsm::poisson_disk_sampler<N> sampler(radius);
+    std::vector<double> points(N * sampler.max_samples());
+    rsm::pcg32 generator(0x5eed0104);
+
+    const rsm::thread_executor executor;
+    size_t total = 0;
+    size_t num_sets = 0;
+    double min_distance = std::numeric_limits<double>::infinity();
+    double sum_mean_nearest_distance = 0.0;
+    for(size_t i=0; i<repetitions; ++i) {
+        const size_t n = rsm::sample(executor, sampler, generator, points.data());
+        if(n > 1) {
+            const rsm::distance_statistics stats = rsm::min_distance_statistics<N>(points.data(), n, false, executor);
+            min_distance = std::min(min_distance, stats.min_distance);
+            sum_mean_nearest_distance += stats.mean_nearest_distance;
+            ++num_sets;
+        }
+        total += n;
+    }
+    ctx.check(name, num_sets > 0 && min_distance >= radius, "n=%zu min=%.4f mean=%.4f",
+        total, min_distance / radius, sum_mean_nearest_distance / (num_sets * radius));
+}
+
+// Samplers drawing from a generator work with standard library engines, not only with rsm's own generators.
+void test_std_generator(context& ctx)
+{
+    std::mt19937 generator(0x5eed0105);
+    std::vector<float> points;
+    const auto check_points = [&ctx, &points](const char* name) {
+        const bool in_range = std::all_of(points.begin(), points.end(), [](float x) { return x >= 0.0f && x < 1.0f; });
+        ctx.check(name, !points.empty() && in_range, "n=%zu", points.size());
+    };
+
+    points.resize(2 * 256);
+    rsm::sample<2>(rsm::random_sampler{}, generator, points.data(), 256);
+    check_points("samplers/std_mt19937/random");
+    rsm::sample<2>(rsm::lhs_sampler{}, generator, points.data(), 256);
+    check_points("samplers/std_mt19937/lhs");
+
+    points.resize(2 * 8 * 8);
+    rsm::sample<2>(rsm::stratified_sampler<2>(8), generator, points.data());
+    check_points("samplers/std_mt19937/stratified");
+
+    const rsm::poisson_disk_sampler<2> poisson_disk(0.05f);
+    points.resize(2 * poisson_disk.max_samples());
+    points.resize(2 * rsm::sample(poisson_disk, generator, points.data()));
+    check_points("samplers/std_mt19937/poisson_disk");
+}
+
+} // namespace
+
+// Sample counts are limited to those with tabulated lattice generating vectors, other counts are tested separately.
+void sampler_tests(context& ctx)
+{
+    rsm::init();
+    if(ctx.long_mode) {
+        test_discrepancy<2>(ctx, 4096, 64);
+        test_discrepancy<3>(ctx, 4096, 16);
+    }
+    else {
+        test_discrepancy<2>(ctx, 1024, 32);
+        test_discrepancy<3>(ctx, 1024, 10);
+    }
+    {
+        // Generating vector computed by lattice_cbc() as 1000 points have no tabulated one.
+        std::vector<double> points(2 * 1000);
+        rsm::sample<2>(rsm::lattice_sampler<2>::precomputed(1000), points.data());
+        check_discrepancy<2>(ctx, "samplers/lattice/l2_star_2d_cbc", points, 0.35);
+    }
+    test_metrics(ctx, ctx.long_mode ? 12288 : 1536);
+    test_poisson_disk<2>(ctx, ctx.long_mode ? 0.005 : 0.02);
+    test_poisson_disk<3>(ctx, ctx.long_mode ? 0.03 : 0.08);
+    // Conflicting points can be three cells apart for radii in (0.43, 0.577); violations showed up in about 1% of sets.
+    test_poisson_disk<3>(ctx, 0.43, 1024);
+    test_poisson_disk<3>(ctx, 0.57, 1024);
+    test_std_generator(ctx);
+    rsm::shutdown();
+}
+
+} // rsm_tests
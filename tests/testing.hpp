@@ -0,0 +1,133 @@
+/*
+ * rsm :: Random Sampling Mathematics
+ * Copyright (c) 2018 Michał Siejak
+ * Released under the MIT license; see LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+namespace rsm_tests {
+
+// Shared state of a test run. Statistical tests report p-values of their statistic; with fixed seeds the results
+// are deterministic so a test fails only if its p-value is extreme on either side (too good is suspicious as well).
+struct context
+{
+    explicit context(bool long_mode)
+        : long_mode(long_mode)
+        , num_checks(0)
+        , num_failures(0)
+    {}
+
+    // Number of samples used by tests: base in fast mode, 64 times more in long mode.
+    size_t scale(size_t base) const
+    {
+        return long_mode ? base * 64 : base;
+    }
+
+    void check_p(const std::string& name, double p)
+    {
+        check(name, p > p_threshold && p < 1.0 - p_threshold, "p=%.6f", p);
+    }
+
+    template<typename... Args>
+    void check(const std::string& name, bool passed, const char* format, Args... args)
+    {
+        ++num_checks;
+        if(!passed) {
+            ++num_failures;
+        }
+        std::printf("[%s] %-48s ", passed ? "  OK  " : " FAIL ", name.c_str());
+        std::printf(format, args...);
+        std::printf("\n");
+    }
+
+    static constexpr double p_threshold = 1e-6;
+
+    bool long_mode;
+    int num_checks;
+    int num_failures;
+};
+
+// Regularized lower incomplete gamma function P(a, x).
+// See: W. H. Press et al., "Numerical Recipes", 6.2.
+inline double gamma_p(double a, double x)
+{
+    if(x <= 0.0) {
+        return 0.0;
+    }
+    const double log_prefix = a * std::log(x) - x - std::lgamma(a);
+    if(x < a + 1.0) {
+        double term = 1.0 / a;
+        double sum = term;
+        for(int n=1; n<1000; ++n) {
+            term *= x / (a + n);
+            sum += term;
+            if(std::abs(term) < std::abs(sum) * 1e-15) {
+                break;
+            }
+        }
+        return sum * std::exp(log_prefix);
+    }
+    else {
+        // Lentz's method for the continued fraction of Q(a, x).
+        const double tiny = 1e-300;
+        double b = x + 1.0 - a;
+        double c = 1.0 / tiny;
+        double d = 1.0 / b;
+        double h = d;
+        for(int n=1; n<1000; ++n) {
+            const double an = -n * (n - a);
+            b += 2.0;
+            d = an * d + b;
+            d = (std::abs(d) < tiny) ? tiny : d;
+            c = b + an / c;
+            c = (std::abs(c) < tiny) ? tiny : c;
+            d = 1.0 / d;
+            const double delta = d * c;
+            h *= delta;
+            if(std::abs(delta - 1.0) < 1e-15) {
+                break;
+            }
+        }
+        return 1.0 - std::exp(log_prefix) * h;
+    }
+}
+
+// Probability that chi-square statistic with given degrees of freedom is less than chi2.
+inline double chi_square_cdf(double chi2, double dof)
+{
+    return gamma_p(0.5 * dof, 0.5 * chi2);
+}
+
+// P(X <= k) for Poisson distributed X with mean lambda.
+inline double poisson_cdf(double k, double lambda)
+{
+    return 1.0 - gamma_p(k + 1.0, lambda);
+}
+
+inline double normal_cdf(double z)
+{
+    return 0.5 * std::erfc(-z / std::sqrt(2.0));
+}
+
+// Pearson's chi-square statistic of observed counts against expected probabilities.
+inline double chi_square(const size_t* observed, const double* probability, size_t num_buckets, size_t total)
+{
+    double chi2 = 0.0;
+    for(size_t i=0; i<num_buckets; ++i) {
+        const double expected = probability[i] * total;
+        const double delta = observed[i] - expected;
+        chi2 += delta * delta / expected;
+    }
+    return chi2;
+}
+
+void generator_tests(context& ctx);
+void sampler_tests(context& ctx);
+int stream_generator(const std::string& name, unsigned long long num_bytes);
+
+} // rsm_tests